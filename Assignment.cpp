@@ -0,0 +1,127 @@
+#include "Assignment.hpp"
+#include <climits>
+#include <algorithm>
+
+Assignment_result Assignment::solve(const Distance& matrix) {
+    int size = matrix.size();
+    Assignment_result result;
+    vector<long long> u(size + 1, 0);
+    vector<long long> v(size + 1, 0);
+    vector<int> assigned_row(size + 1, 0);
+    vector<int> way(size + 1, 0);
+    vector<long long> min_value(size + 1);
+    vector<char> used(size + 1);
+
+    for(int row = 1; row <= size; row++) {
+        assigned_row[0] = row;
+        int column = 0;
+        fill(min_value.begin(), min_value.end(), LLONG_MAX);
+        fill(used.begin(), used.end(), 0);
+
+        do {
+            used[column] = 1;
+            int current_row = assigned_row[column];
+            long long delta = LLONG_MAX;
+            int next_column = 0;
+
+            for(int j = 1; j <= size; j++) {
+                if(used[j]) continue;
+                long long reduced = cost(matrix, current_row - 1, j - 1) - u[current_row] - v[j];
+                if(reduced < min_value[j]) {
+                    min_value[j] = reduced;
+                    way[j] = column;
+                }
+                if(min_value[j] < delta) {
+                    delta = min_value[j];
+                    next_column = j;
+                }
+            }
+            for(int j = 0; j <= size; j++) {
+                if(used[j]) {
+                    u[assigned_row[j]] += delta;
+                    v[j] -= delta;
+                } else min_value[j] -= delta;
+            }
+            column = next_column;
+        } while(assigned_row[column] != 0);
+
+        do {
+            int previous_column = way[column];
+            assigned_row[column] = assigned_row[previous_column];
+            column = previous_column;
+        } while(column != 0);
+    }
+
+    result.successors.assign(size, -1);
+    result.value = 0;
+    for(int j = 1; j <= size; j++) {
+        result.successors[assigned_row[j] - 1] = j - 1;
+        result.value += cost(matrix, assigned_row[j] - 1, j - 1);
+    }
+    if(result.value >= forbidden_cost) return Assignment_result();
+    return result;
+}
+
+pair<vector<int>, Cost> Assignment::patch(const Distance& matrix, vector<int> successors) {
+    int size = matrix.size();
+    vector<int> cycle_sizes;
+    vector<int> cycles = label_cycles(successors, cycle_sizes);
+
+    while(cycle_sizes.size() > 1) {
+        int largest = max_element(cycle_sizes.begin(), cycle_sizes.end()) - cycle_sizes.begin();
+        long long best_cost = LLONG_MAX;
+        int best_a = -1;
+        int best_b = -1;
+
+        for(int a = 0; a < size; a++) {
+            if(cycles[a] != largest) continue;
+            for(int b = 0; b < size; b++) {
+                if(cycles[b] == largest) continue;
+                if(cost(matrix, a, successors[b]) == forbidden_cost || cost(matrix, b, successors[a]) == forbidden_cost) continue;
+                long long patch_cost = cost(matrix, a, successors[b]) + cost(matrix, b, successors[a]) -
+                                       cost(matrix, a, successors[a]) - cost(matrix, b, successors[b]);
+                if(patch_cost < best_cost) {
+                    best_cost = patch_cost;
+                    best_a = a;
+                    best_b = b;
+                }
+            }
+        }
+        if(best_a == -1) return {vector<int>(), infinite_cost};
+
+        swap(successors[best_a], successors[best_b]);
+        cycles = label_cycles(successors, cycle_sizes);
+    }
+
+    pair<vector<int>, Cost> results(vector<int>(), 0);
+    int node = 0;
+    do {
+        results.first.push_back(node);
+        results.second = results.second + matrix.at(node, successors[node]);
+        node = successors[node];
+    } while(node != 0);
+    results.first.push_back(0);
+    return results;
+}
+
+long long Assignment::cost(const Distance& matrix, int from, int to) {
+    if(from == to || matrix.at(from, to) == -1) return forbidden_cost;
+    return matrix.at(from, to);
+}
+
+vector<int> Assignment::label_cycles(const vector<int>& successors, vector<int>& cycle_sizes) {
+    vector<int> cycles(successors.size(), -1);
+    cycle_sizes.clear();
+
+    for(int start = 0; start < successors.size(); start++) {
+        if(cycles[start] != -1) continue;
+        int node = start;
+        cycle_sizes.push_back(0);
+        while(cycles[node] == -1) {
+            cycles[node] = cycle_sizes.size() - 1;
+            cycle_sizes.back()++;
+            node = successors[node];
+        }
+    }
+    return cycles;
+}
@@ -0,0 +1,27 @@
+#ifndef ASSIGNMENT_HPP
+#define ASSIGNMENT_HPP
+#include "Distance.hpp"
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+struct Assignment_result {
+    long long value = -1;
+    vector<int> successors;
+};
+
+class Assignment {
+
+public:
+    static Assignment_result solve(const Distance& matrix);
+    static pair<vector<int>, Cost> patch(const Distance& matrix, vector<int> successors);
+
+private:
+    static const long long forbidden_cost = 1000000000000LL;
+
+    static long long cost(const Distance& matrix, int from, int to);
+    static vector<int> label_cycles(const vector<int>& successors, vector<int>& cycle_sizes);
+};
+
+#endif
@@ -0,0 +1,186 @@
+#include "Benchmark.hpp"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+using namespace std;
+
+static atomic<long long> allocation_count{0};
+
+void* operator new(size_t size) {
+    allocation_count.fetch_add(1, memory_order_relaxed);
+    if(void* pointer = malloc(size == 0 ? 1 : size)) return pointer;
+    throw bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    free(pointer);
+}
+
+void* operator new(size_t size, align_val_t alignment) {
+    allocation_count.fetch_add(1, memory_order_relaxed);
+    size_t bytes = (max<size_t>(size, 1) + size_t(alignment) - 1) / size_t(alignment) * size_t(alignment);
+#ifdef _WIN32
+    if(void* pointer = _aligned_malloc(bytes, size_t(alignment))) return pointer;
+#else
+    if(void* pointer = aligned_alloc(size_t(alignment), bytes)) return pointer;
+#endif
+    throw bad_alloc();
+}
+
+void operator delete(void* pointer, align_val_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    free(pointer);
+#endif
+}
+
+void operator delete(void* pointer, size_t, align_val_t alignment) noexcept {
+    operator delete(pointer, alignment);
+}
+
+void Benchmark::run(const string& data_directory, const string& output_path) {
+    ofstream file(output_path, ios::trunc);
+    outputs = {&cout};
+    if(file.is_open()) outputs.push_back(&file);
+    else cerr << "Nie udalo sie otworzyc pliku wynikow: " << output_path << endl;
+
+    for(ostream* output : outputs) *output << "Instancja,Jadro,Rozmiar,Operacje,ns/operacje,Sasiedzi/s,Alokacje/operacje" << "\n";
+    for(const string& path : find_instances(data_directory)) benchmark_instance(path);
+    file.close();
+}
+
+vector<string> Benchmark::find_instances(const string& data_directory) {
+    vector<string> paths;
+    error_code error;
+
+    for(const auto& entry : filesystem::directory_iterator(data_directory, error)) {
+        string name = entry.path().filename().string();
+        if(entry.is_regular_file() && name.rfind("data", 0) == 0 && name.size() > 4 && name.substr(name.size() - 4) == ".txt") paths.push_back(entry.path().string());
+    }
+    sort(paths.begin(), paths.end());
+    return paths;
+}
+
+Benchmark_result Benchmark::measure(const function<long long()>& operation) const {
+    Benchmark_result result;
+    operation();
+
+    long long allocations_before = allocation_count.load(memory_order_relaxed);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(long long batch = 1; result.time < minimum_time; batch = batch * 2) {
+        for(long long k = 0; k < batch; k++) result.neighbours = result.neighbours + operation();
+        result.operations = result.operations + batch;
+        result.time = chrono::steady_clock::now() - start;
+    }
+    result.allocations = allocation_count.load(memory_order_relaxed) - allocations_before;
+    return result;
+}
+
+void Benchmark::benchmark_instance(const string& path) {
+    string name = path.substr(path.find_last_of("/\\") + 1);
+    Instance data = File_manager().read_data_file(path);
+    if(!data.matrix) {
+        cerr << "Pominieto instancje: " << name << endl;
+        return;
+    }
+    int size = data.matrix->size();
+
+    write_result(name, "read_data_file", size, measure([&]() {
+        File_manager().read_data_file(path);
+        return 0LL;
+    }));
+
+    TSP tsp;
+    write_result(name, "set_matrix", size, measure([&]() {
+        tsp.set_matrix(data.matrix);
+        return 0LL;
+    }));
+    write_result(name, "set_matrix_candidates_8", size, measure([&]() {
+        tsp.set_matrix(data.matrix, 8);
+        return 0LL;
+    }));
+
+    tsp.set_matrix(data.matrix);
+    tsp.set_seed(1, 0);
+    vector<int> tour = tsp.random().first;
+    long long checksum = 0;
+
+    write_result(name, "calculate_path_length", size, measure([&]() {
+        checksum = checksum + tsp.calculate_path_length(tour);
+        return 0LL;
+    }));
+    write_result(name, "random", size, measure([&]() {
+        checksum = checksum + tsp.random().second;
+        return 0LL;
+    }));
+    write_result(name, "NN", size, measure([&]() {
+        checksum = checksum + tsp.NN().second;
+        return 0LL;
+    }));
+
+    const char* operators[] = {"swap", "inversion", "insertion", "or_opt"};
+    for(int candidates : {0, 8}) {
+        tsp.set_matrix(data.matrix, candidates);
+        tsp.set_dont_look_bits(false);
+        tsp.set_path_state(tour);
+        for(int solution_generator = 1; solution_generator <= 4; solution_generator++) {
+            string kernel = string(candidates > 0 ? "generate_granular_surroundings_" : "generate_surroundings_") + operators[solution_generator - 1];
+            write_result(name, kernel, size, measure([&]() {
+                return tsp.count_surroundings(tour, solution_generator);
+            }));
+        }
+    }
+
+    Tabu_list tabu_list;
+    tabu_list.set_capacity(size);
+    vector<pair<int, int>> edges(4096);
+    for(auto& edge : edges) edge = make_pair(tsp.generator.uniform(size), tsp.generator.uniform(size));
+    size_t next_edge = 0;
+    int iteration = 0;
+
+    write_result(name, "tabu_list_insert", size, measure([&]() {
+        const pair<int, int>& edge = edges[next_edge++ % edges.size()];
+        tabu_list.insert(edge.first, edge.second, ++iteration + size);
+        return 0LL;
+    }));
+    write_result(name, "tabu_list_is_tabu", size, measure([&]() {
+        const pair<int, int>& edge = edges[next_edge++ % edges.size()];
+        checksum = checksum + tabu_list.is_tabu(edge.second, edge.first, iteration);
+        return 0LL;
+    }));
+
+    sink = sink + checksum;
+}
+
+void Benchmark::write_result(const string& instance, const string& kernel, int size, const Benchmark_result& result) {
+    double nanoseconds_per_operation = result.time.count() / result.operations;
+    double neighbours_per_second = result.neighbours / chrono::duration<double>(result.time).count();
+    double allocations_per_operation = double(result.allocations) / result.operations;
+
+    for(ostream* output : outputs) {
+        *output << instance << "," << kernel << "," << size << "," << result.operations << "," << nanoseconds_per_operation << ","
+                << neighbours_per_second << "," << allocations_per_operation << "\n";
+        output->flush();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    string data_directory = argc > 1 ? argv[1] : "files";
+    string output_path = argc > 2 ? argv[2] : data_directory + "/benchmark.csv";
+    Benchmark().run(data_directory, output_path);
+
+    return 0;
+}
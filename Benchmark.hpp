@@ -0,0 +1,36 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+#include "File_manager.hpp"
+#include "TSP.hpp"
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <ostream>
+
+using namespace std;
+
+struct Benchmark_result {
+    long long operations = 0;
+    long long neighbours = 0;
+    long long allocations = 0;
+    chrono::duration<double, nano> time{};
+};
+
+class Benchmark {
+
+public:
+    void run(const string& data_directory, const string& output_path);
+
+private:
+    chrono::milliseconds minimum_time{100};
+    vector<ostream*> outputs;
+    volatile long long sink = 0;
+
+    static vector<string> find_instances(const string& data_directory);
+    Benchmark_result measure(const function<long long()>& operation) const;
+    void benchmark_instance(const string& path);
+    void write_result(const string& instance, const string& kernel, int size, const Benchmark_result& result);
+};
+
+#endif
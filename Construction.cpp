@@ -0,0 +1,233 @@
+#include "Construction.hpp"
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <climits>
+#include <functional>
+
+pair<vector<int>, Cost> Construction::greedy_edge(const Distance& matrix) {
+    int size = matrix.size();
+    vector<vector<int>> neighbours(size);
+    vector<int> next_candidate(size, 0);
+    vector<int> next(size, -1);
+    vector<char> has_predecessor(size, 0);
+    vector<int> fragment(size);
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> queue;
+    int edges = 0;
+
+    iota(fragment.begin(), fragment.end(), 0);
+    function<int(int)> find_fragment = [&](int node) {
+        while(fragment[node] != node) node = fragment[node] = fragment[fragment[node]];
+        return node;
+    };
+
+    for(int i = 0; i < size; i++) {
+        for(int j = 0; j < size; j++) if(j != i && matrix.at(i, j) != -1) neighbours[i].push_back(j);
+        sort(neighbours[i].begin(), neighbours[i].end(), [&](int a, int b) { return matrix.at(i, a) < matrix.at(i, b); });
+        if(!neighbours[i].empty()) queue.emplace(matrix.at(i, neighbours[i][0]), i);
+    }
+
+    while(edges < size - 1 && !queue.empty()) {
+        int from = queue.top().second;
+        queue.pop();
+        int to = neighbours[from][next_candidate[from]];
+
+        if(!has_predecessor[to] && find_fragment(from) != find_fragment(to)) {
+            next[from] = to;
+            has_predecessor[to] = 1;
+            fragment[find_fragment(from)] = find_fragment(to);
+            edges++;
+            continue;
+        }
+        while(++next_candidate[from] < neighbours[from].size()) {
+            to = neighbours[from][next_candidate[from]];
+            if(!has_predecessor[to] && find_fragment(from) != find_fragment(to)) {
+                queue.emplace(matrix.at(from, to), from);
+                break;
+            }
+        }
+    }
+    if(edges < size - 1) return {vector<int>(), infinite_cost};
+
+    int head = find(has_predecessor.begin(), has_predecessor.end(), 0) - has_predecessor.begin();
+    int tail = find(next.begin(), next.end(), -1) - next.begin();
+    next[tail] = head;
+    return successors_to_path(matrix, next, head);
+}
+
+pair<vector<int>, Cost> Construction::cheapest_insertion(const Distance& matrix) {
+    int size = matrix.size();
+    vector<int> next(size, -1);
+    vector<Cost> best_cost(size, infinite_cost);
+    vector<int> best_edge(size, -1);
+    if(initial_cycle(matrix, next) == -1) return {vector<int>(), infinite_cost};
+
+    int start_node = 0;
+    auto rescan = [&](int node) {
+        best_cost[node] = infinite_cost;
+        best_edge[node] = -1;
+        int from = start_node;
+        do {
+            Cost cost = insertion_cost(matrix, from, node, next[from]);
+            if(cost < best_cost[node]) {
+                best_cost[node] = cost;
+                best_edge[node] = from;
+            }
+            from = next[from];
+        } while(from != start_node);
+    };
+    for(int node = 0; node < size; node++) if(next[node] == -1) rescan(node);
+
+    for(int inserted = 2; inserted < size; inserted++) {
+        int node = -1;
+        for(int k = 0; k < size; k++) if(next[k] == -1 && best_edge[k] != -1 && (node == -1 || best_cost[k] < best_cost[node])) node = k;
+        if(node == -1) return {vector<int>(), infinite_cost};
+
+        int from = best_edge[node];
+        int to = next[from];
+        next[from] = node;
+        next[node] = to;
+
+        for(int k = 0; k < size; k++) {
+            if(next[k] != -1) continue;
+            if(best_edge[k] == from) rescan(k);
+            else {
+                for(int edge_from : {from, node}) {
+                    Cost cost = insertion_cost(matrix, edge_from, k, next[edge_from]);
+                    if(cost < best_cost[k]) {
+                        best_cost[k] = cost;
+                        best_edge[k] = edge_from;
+                    }
+                }
+            }
+        }
+    }
+    return successors_to_path(matrix, next, start_node);
+}
+
+pair<vector<int>, Cost> Construction::farthest_insertion(const Distance& matrix) {
+    int size = matrix.size();
+    vector<int> next(size, -1);
+    vector<int> tour_distance(size, INT_MAX);
+    if(initial_cycle(matrix, next) == -1) return {vector<int>(), infinite_cost};
+
+    auto update_distances = [&](int tour_node) {
+        for(int k = 0; k < size; k++) {
+            if(next[k] != -1) continue;
+            if(matrix.at(tour_node, k) != -1) tour_distance[k] = min(tour_distance[k], matrix.at(tour_node, k));
+            if(matrix.at(k, tour_node) != -1) tour_distance[k] = min(tour_distance[k], matrix.at(k, tour_node));
+        }
+    };
+    update_distances(0);
+    update_distances(next[0]);
+
+    for(int inserted = 2; inserted < size; inserted++) {
+        int node = -1;
+        for(int k = 0; k < size; k++) {
+            if(next[k] == -1 && tour_distance[k] != INT_MAX && (node == -1 || tour_distance[k] > tour_distance[node])) node = k;
+        }
+        if(node == -1) return {vector<int>(), infinite_cost};
+
+        Cost best_cost = infinite_cost;
+        int best_from = -1;
+        int from = 0;
+        do {
+            Cost cost = insertion_cost(matrix, from, node, next[from]);
+            if(cost < best_cost) {
+                best_cost = cost;
+                best_from = from;
+            }
+            from = next[from];
+        } while(from != 0);
+        if(best_from == -1) return {vector<int>(), infinite_cost};
+
+        next[node] = next[best_from];
+        next[best_from] = node;
+        update_distances(node);
+    }
+    return successors_to_path(matrix, next, 0);
+}
+
+pair<vector<int>, Cost> Construction::space_filling_curve(const Distance& matrix, const vector<pair<double, double>>& coordinates) {
+    const int order = 16;
+    if(coordinates.size() != matrix.size()) return {vector<int>(), infinite_cost};
+
+    double min_x = coordinates[0].first, max_x = coordinates[0].first;
+    double min_y = coordinates[0].second, max_y = coordinates[0].second;
+    for(const auto& point : coordinates) {
+        min_x = min(min_x, point.first);
+        max_x = max(max_x, point.first);
+        min_y = min(min_y, point.second);
+        max_y = max(max_y, point.second);
+    }
+    double scale = ((1u << order) - 1) / max(max(max_x - min_x, max_y - min_y), 1e-9);
+
+    vector<unsigned long long> curve_index(coordinates.size());
+    for(int i = 0; i < coordinates.size(); i++) {
+        curve_index[i] = hilbert_index(unsigned((coordinates[i].first - min_x) * scale), unsigned((coordinates[i].second - min_y) * scale), order);
+    }
+
+    vector<int> order_of_nodes(coordinates.size());
+    iota(order_of_nodes.begin(), order_of_nodes.end(), 0);
+    sort(order_of_nodes.begin(), order_of_nodes.end(), [&](int a, int b) { return curve_index[a] < curve_index[b]; });
+    return order_to_path(matrix, order_of_nodes);
+}
+
+Cost Construction::insertion_cost(const Distance& matrix, int from, int node, int to) {
+    if(matrix.at(from, node) == -1 || matrix.at(node, to) == -1) return infinite_cost;
+    return Cost(matrix.at(from, node)) + matrix.at(node, to) - matrix.at(from, to);
+}
+
+int Construction::initial_cycle(const Distance& matrix, vector<int>& next) {
+    int best_node = -1;
+
+    for(int j = 1; j < matrix.size(); j++) {
+        if(matrix.at(0, j) == -1 || matrix.at(j, 0) == -1) continue;
+        if(best_node == -1 || Cost(matrix.at(0, j)) + matrix.at(j, 0) < Cost(matrix.at(0, best_node)) + matrix.at(best_node, 0)) best_node = j;
+    }
+    if(best_node == -1) return -1;
+
+    next[0] = best_node;
+    next[best_node] = 0;
+    return best_node;
+}
+
+pair<vector<int>, Cost> Construction::successors_to_path(const Distance& matrix, const vector<int>& next, int start_node) {
+    vector<int> order;
+    int node = start_node;
+
+    do {
+        order.push_back(node);
+        node = next[node];
+    } while(node != start_node && order.size() <= matrix.size());
+    return order_to_path(matrix, order);
+}
+
+pair<vector<int>, Cost> Construction::order_to_path(const Distance& matrix, const vector<int>& order) {
+    pair<vector<int>, Cost> results(order, 0);
+    results.first.push_back(order.front());
+
+    for(int i = 0; i + 1 < results.first.size(); i++) {
+        if(matrix.at(results.first[i], results.first[i + 1]) == -1) return {vector<int>(), infinite_cost};
+        results.second = results.second + matrix.at(results.first[i], results.first[i + 1]);
+    }
+    return results;
+}
+
+unsigned long long Construction::hilbert_index(unsigned x, unsigned y, int order) {
+    unsigned long long index = 0;
+
+    for(unsigned s = 1u << (order - 1); s > 0; s /= 2) {
+        unsigned rx = (x & s) > 0;
+        unsigned ry = (y & s) > 0;
+        index = index + (unsigned long long)s * s * ((3 * rx) ^ ry);
+        if(ry == 0) {
+            if(rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            swap(x, y);
+        }
+    }
+    return index;
+}
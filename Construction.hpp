@@ -0,0 +1,25 @@
+#ifndef CONSTRUCTION_HPP
+#define CONSTRUCTION_HPP
+#include "Distance.hpp"
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+class Construction {
+
+public:
+    static pair<vector<int>, Cost> greedy_edge(const Distance& matrix);
+    static pair<vector<int>, Cost> cheapest_insertion(const Distance& matrix);
+    static pair<vector<int>, Cost> farthest_insertion(const Distance& matrix);
+    static pair<vector<int>, Cost> space_filling_curve(const Distance& matrix, const vector<pair<double, double>>& coordinates);
+
+private:
+    static Cost insertion_cost(const Distance& matrix, int from, int node, int to);
+    static int initial_cycle(const Distance& matrix, vector<int>& next);
+    static pair<vector<int>, Cost> successors_to_path(const Distance& matrix, const vector<int>& next, int start_node);
+    static pair<vector<int>, Cost> order_to_path(const Distance& matrix, const vector<int>& order);
+    static unsigned long long hilbert_index(unsigned x, unsigned y, int order);
+};
+
+#endif
@@ -0,0 +1,26 @@
+#include "Convergence_trace.hpp"
+#include <algorithm>
+
+void Convergence_trace::set_capacity(int capacity, int sampling_interval) {
+    points.assign(max(capacity, 0), Trace_point{});
+    this -> sampling_interval = sampling_interval;
+    total = 0;
+}
+
+void Convergence_trace::clear() {
+    total = 0;
+}
+
+void Convergence_trace::record(int iteration, int64_t elapsed_ns, Cost current_cost, Cost best_cost, bool restart) {
+    points[total % points.size()] = Trace_point{iteration, elapsed_ns, current_cost, best_cost, restart};
+    total++;
+}
+
+int Convergence_trace::size() const {
+    return total < points.size() ? int(total) : int(points.size());
+}
+
+const Trace_point& Convergence_trace::operator[](int index) const {
+    long long first = total < points.size() ? 0 : total - points.size();
+    return points[(first + index) % points.size()];
+}
@@ -0,0 +1,35 @@
+#ifndef CONVERGENCE_TRACE_HPP
+#define CONVERGENCE_TRACE_HPP
+#include <vector>
+#include "Distance.hpp"
+#include <cstdint>
+
+using namespace std;
+
+struct Trace_point {
+    int iteration;
+    int64_t elapsed_ns;
+    Cost current_cost;
+    Cost best_cost;
+    bool restart;
+};
+
+class Convergence_trace {
+
+public:
+    void set_capacity(int capacity, int sampling_interval);
+    void clear();
+    bool is_enabled() const { return !points.empty(); }
+    bool is_sample_due(int iteration) const { return sampling_interval > 0 && iteration % sampling_interval == 0; }
+    void record(int iteration, int64_t elapsed_ns, Cost current_cost, Cost best_cost, bool restart);
+
+    int size() const;
+    const Trace_point& operator[](int index) const;
+
+private:
+    vector<Trace_point> points;
+    int sampling_interval = 0;
+    long long total = 0;
+};
+
+#endif
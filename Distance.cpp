@@ -0,0 +1,15 @@
+#include "Distance.hpp"
+#include <algorithm>
+
+void Distance::nearest_neighbours(int city, int count, vector<int>& neighbours) const {
+    vector<pair<int, int>> distances;
+
+    for(int j = 0; j < matrix_size; j++) {
+        if(j != city && at(city, j) != -1) distances.emplace_back(at(city, j), j);
+    }
+    count = min(count, int(distances.size()));
+    partial_sort(distances.begin(), distances.begin() + count, distances.end());
+
+    neighbours.clear();
+    for(int k = 0; k < count; k++) neighbours.push_back(distances[k].second);
+}
@@ -0,0 +1,48 @@
+#ifndef DISTANCE_HPP
+#define DISTANCE_HPP
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <climits>
+
+using namespace std;
+
+using Cost = long long;
+constexpr Cost infinite_cost = LLONG_MAX;
+
+class Distance {
+
+public:
+    virtual ~Distance() = default;
+
+    int size() const { return matrix_size; }
+    int stride() const { return row_stride; }
+    bool is_dense() const { return dense != nullptr; }
+    int weight_size() const { return element_size; }
+    const void* values() const { return dense; }
+    size_t bytes() const { return size_t(row_stride) * matrix_size * element_size; }
+
+    int at(int from, int to) const {
+        size_t index = size_t(from) * row_stride + to;
+        if(element_size == sizeof(int32_t)) return static_cast<const int32_t*>(dense)[index];
+        if(element_size == sizeof(uint16_t)) return decode(static_cast<const uint16_t*>(dense)[index]);
+        if(element_size == sizeof(uint8_t)) return decode(static_cast<const uint8_t*>(dense)[index]);
+        return compute(from, to);
+    }
+
+    virtual void nearest_neighbours(int city, int count, vector<int>& neighbours) const;
+
+    static int decode(int32_t value) { return value; }
+    static int decode(uint16_t value) { return value == UINT16_MAX ? -1 : value; }
+    static int decode(uint8_t value) { return value == UINT8_MAX ? -1 : value; }
+
+protected:
+    int matrix_size = 0;
+    int row_stride = 0;
+    int element_size = 0;
+    const void* dense = nullptr;
+
+    virtual int compute(int from, int to) const = 0;
+};
+
+#endif
@@ -0,0 +1,28 @@
+#include "Distance_matrix.hpp"
+
+template<typename Weight>
+Basic_distance_matrix<Weight>::Basic_distance_matrix(int size) {
+    set_layout(size);
+    values.assign(size_t(row_stride) * size, forbidden);
+    data = values.data();
+    dense = data;
+}
+
+template<typename Weight>
+Basic_distance_matrix<Weight>::Basic_distance_matrix(int size, shared_ptr<Mapped_file> mapping, size_t offset) : mapping(std::move(mapping)) {
+    set_layout(size);
+    data = reinterpret_cast<Weight*>(this -> mapping -> data() + offset);
+    dense = data;
+}
+
+template<typename Weight>
+void Basic_distance_matrix<Weight>::set_layout(int size) {
+    int row_alignment = cache_line / sizeof(Weight);
+    matrix_size = size;
+    row_stride = (size + row_alignment - 1) / row_alignment * row_alignment;
+    element_size = sizeof(Weight);
+}
+
+template class Basic_distance_matrix<uint8_t>;
+template class Basic_distance_matrix<uint16_t>;
+template class Basic_distance_matrix<int32_t>;
@@ -0,0 +1,63 @@
+#ifndef DISTANCE_MATRIX_HPP
+#define DISTANCE_MATRIX_HPP
+#include "Distance.hpp"
+#include "Mapped_file.hpp"
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+using namespace std;
+
+template<typename T, size_t Alignment>
+struct Aligned_allocator {
+    using value_type = T;
+    template<typename U> struct rebind { using other = Aligned_allocator<U, Alignment>; };
+
+    Aligned_allocator() = default;
+    template<typename U> Aligned_allocator(const Aligned_allocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), align_val_t(Alignment))); }
+    void deallocate(T* pointer, size_t) { ::operator delete(pointer, align_val_t(Alignment)); }
+
+    template<typename U> bool operator==(const Aligned_allocator<U, Alignment>&) const { return true; }
+    template<typename U> bool operator!=(const Aligned_allocator<U, Alignment>&) const { return false; }
+};
+
+template<typename Weight>
+class Basic_distance_matrix : public Distance {
+
+public:
+    static constexpr size_t cache_line = 64;
+    static constexpr Weight forbidden = numeric_limits<Weight>::is_signed ? Weight(-1) : numeric_limits<Weight>::max();
+
+    Basic_distance_matrix() = default;
+    explicit Basic_distance_matrix(int size);
+    Basic_distance_matrix(int size, shared_ptr<Mapped_file> mapping, size_t offset);
+    Basic_distance_matrix(const Basic_distance_matrix&) = delete;
+    Basic_distance_matrix& operator=(const Basic_distance_matrix&) = delete;
+
+    Weight* row(int from) { return &data[size_t(from) * row_stride]; }
+    const Weight* row(int from) const { return &data[size_t(from) * row_stride]; }
+    static Weight encode(int value) { return value == -1 ? forbidden : Weight(value); }
+
+protected:
+    int compute(int from, int to) const override { return decode(data[size_t(from) * row_stride + to]); }
+
+private:
+    Weight* data = nullptr;
+    vector<Weight, Aligned_allocator<Weight, cache_line>> values;
+    shared_ptr<Mapped_file> mapping;
+
+    void set_layout(int size);
+};
+
+using Distance_matrix = Basic_distance_matrix<int32_t>;
+
+extern template class Basic_distance_matrix<uint8_t>;
+extern template class Basic_distance_matrix<uint16_t>;
+extern template class Basic_distance_matrix<int32_t>;
+
+#endif
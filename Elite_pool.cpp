@@ -0,0 +1,60 @@
+#include "Elite_pool.hpp"
+#include <algorithm>
+
+Elite_pool::Elite_pool(int capacity, int tour_size) : capacity(capacity), tour_size(tour_size), slots(new Slot[capacity]) {
+    for(int i = 0; i < capacity; i++) slots[i].tour.reset(new atomic<int>[tour_size]);
+}
+
+bool Elite_pool::publish(const vector<int>& tour, Cost length) {
+    int worst = 0;
+
+    for(int i = 0; i < capacity; i++) {
+        Cost slot_length = slots[i].length.load(memory_order_relaxed);
+        if(slot_length == length) return false;
+        if(slot_length > slots[worst].length.load(memory_order_relaxed)) worst = i;
+    }
+
+    Slot& slot = slots[worst];
+    unsigned sequence = slot.sequence.load(memory_order_relaxed);
+    if(sequence % 2 == 1 || length >= slot.length.load(memory_order_relaxed)) return false;
+    if(!slot.sequence.compare_exchange_strong(sequence, sequence + 1, memory_order_acquire)) return false;
+    atomic_thread_fence(memory_order_release);
+
+    for(int i = 0; i < tour_size; i++) slot.tour[i].store(tour[i], memory_order_relaxed);
+    slot.length.store(length, memory_order_relaxed);
+
+    slot.sequence.store(sequence + 2, memory_order_release);
+    return true;
+}
+
+bool Elite_pool::sample(vector<int>& tour, Cost& length, Random& generator) const {
+    int first = generator.uniform(capacity);
+
+    for(int k = 0; k < capacity; k++) {
+        const Slot& slot = slots[(first + k) % capacity];
+        if(slot.length.load(memory_order_relaxed) != infinite_cost && read_slot(slot, tour, length)) return true;
+    }
+    return false;
+}
+
+Cost Elite_pool::best_length() const {
+    Cost best = infinite_cost;
+    for(int i = 0; i < capacity; i++) best = min(best, slots[i].length.load(memory_order_relaxed));
+    return best;
+}
+
+bool Elite_pool::read_slot(const Slot& slot, vector<int>& tour, Cost& length) const {
+    tour.resize(tour_size);
+
+    for(int attempt = 0; attempt < 16; attempt++) {
+        unsigned sequence = slot.sequence.load(memory_order_acquire);
+        if(sequence % 2 == 1) continue;
+
+        for(int i = 0; i < tour_size; i++) tour[i] = slot.tour[i].load(memory_order_relaxed);
+        length = slot.length.load(memory_order_relaxed);
+
+        atomic_thread_fence(memory_order_acquire);
+        if(slot.sequence.load(memory_order_relaxed) == sequence) return length != infinite_cost;
+    }
+    return false;
+}
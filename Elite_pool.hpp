@@ -0,0 +1,34 @@
+#ifndef ELITE_POOL_HPP
+#define ELITE_POOL_HPP
+#include "Distance.hpp"
+#include "Random.hpp"
+#include <vector>
+#include <atomic>
+#include <memory>
+
+using namespace std;
+
+class Elite_pool {
+
+public:
+    Elite_pool(int capacity, int tour_size);
+
+    bool publish(const vector<int>& tour, Cost length);
+    bool sample(vector<int>& tour, Cost& length, Random& generator) const;
+    Cost best_length() const;
+
+private:
+    struct Slot {
+        atomic<unsigned> sequence{0};
+        atomic<Cost> length{infinite_cost};
+        unique_ptr<atomic<int>[]> tour;
+    };
+
+    int capacity;
+    int tour_size;
+    unique_ptr<Slot[]> slots;
+
+    bool read_slot(const Slot& slot, vector<int>& tour, Cost& length) const;
+};
+
+#endif
@@ -1,9 +1,17 @@
 #include "File_manager.hpp"
+#include "Mapped_file.hpp"
+#include "Haversine_builder.hpp"
+#include "Implicit_distance.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <cmath>
 #include <tuple>
+#include <charconv>
+#include <cstring>
+#include <cctype>
+#include <cstdio>
+#include <random>
 
 using namespace std;
 
@@ -33,94 +41,362 @@ tuple<vector<string>, vector<int>, vector<float>> File_manager::read_config_file
     return results;
 }
 
-pair<vector<vector<int>>, int> File_manager::read_data_file(const string& path) {
-    pair<vector<vector<int>>, int> data;
-    vector<vector<int>> matrix;
-    vector<vector<double>> buffer;
-    string line;
-    ifstream file;
+Instance File_manager::read_data_file(const string& path, bool use_cache, bool implicit_distances) {
+    Instance data;
+    Mapped_file file(path);
+    if(!file.is_open() || file.size() == 0) return data;
 
-    file.open(path);
+    const char* cursor = file.data();
+    const char* end = cursor + file.size();
+    use_cache = use_cache && !implicit_distances;
+    uint64_t source_hash = use_cache ? hash_source(cursor, file.size()) : 0;
+    if(use_cache) {
+        data = read_matrix_cache(path + ".bin", source_hash, file.size());
+        if(data.matrix) return read_optimal_value(path + ".opt", data);
+    }
 
-    if(file.is_open()) {
-        getline(file, line);
-        if(stoi(line) == 0) {
-            getline(file, line);
-            int size = stoi(line);
-            for(int i = 0; i < size; i++) {
-                getline(file, line);
-                stringstream ss(line);
-                vector<int> row;
-                int number;
-                while(ss >> number) row.push_back(number);
-                matrix.push_back(row);
-            }
-        } else if(stoi(line) == 1) {
-            getline(file, line);
-            int size = stoi(line);
+    while(cursor != end && isspace(static_cast<unsigned char>(*cursor))) cursor++;
+    if(cursor != end && isdigit(static_cast<unsigned char>(*cursor))) data = read_custom_file(cursor, end, implicit_distances);
+    else data = read_tsplib_file(cursor, end);
+
+    shared_ptr<Distance_matrix> matrix = dynamic_pointer_cast<Distance_matrix>(data.matrix);
+    if(matrix) data.matrix = compact_matrix(matrix);
+    if(use_cache && data.matrix && data.matrix->is_dense()) write_matrix_cache(path + ".bin", source_hash, file.size(), data);
+    return read_optimal_value(path + ".opt", data);
+}
+
+Instance File_manager::read_optimal_value(const string& path, Instance& data) {
+    if(!data.matrix || data.optimal_value >= 0) return data;
+
+    ifstream file(path);
+    if(!(file >> data.optimal_value)) data.optimal_value = -1;
+    return data;
+}
+
+uint64_t File_manager::hash_source(const char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+
+    size_t i = 0;
+
+    for(; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ULL;
+    }
+    for(; i < size; i++) hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+    return hash;
+}
+
+Instance File_manager::read_matrix_cache(const string& path, uint64_t source_hash, uint64_t source_size) {
+    Instance data;
+    shared_ptr<Mapped_file> file = make_shared<Mapped_file>(path, true);
+    if(!file->is_open() || file->size() < sizeof(Matrix_cache_header)) return data;
+
+    Matrix_cache_header header{};
+    memcpy(&header, file->data(), sizeof(header));
+    if(memcmp(header.magic, "PEAMTX3", 8) != 0 || header.source_hash != source_hash || header.source_size != source_size || header.size <= 0) return data;
+
+    size_t coordinates_offset = sizeof(Matrix_cache_header);
+    size_t matrix_offset = (coordinates_offset + header.coordinate_count * sizeof(pair<double, double>) + Distance_matrix::cache_line - 1) /
+                           Distance_matrix::cache_line * Distance_matrix::cache_line;
+    shared_ptr<Distance> matrix;
+    if(header.weight_size == sizeof(uint8_t)) matrix = make_shared<Basic_distance_matrix<uint8_t>>(header.size, file, matrix_offset);
+    else if(header.weight_size == sizeof(uint16_t)) matrix = make_shared<Basic_distance_matrix<uint16_t>>(header.size, file, matrix_offset);
+    else if(header.weight_size == sizeof(int32_t)) matrix = make_shared<Distance_matrix>(header.size, file, matrix_offset);
+    else return data;
+    if(matrix->stride() != header.stride || file->size() != matrix_offset + matrix->bytes()) return data;
+
+    const double* coordinates = reinterpret_cast<const double*>(file->data() + coordinates_offset);
+    for(size_t i = 0; i < header.coordinate_count; i++) data.coordinates.emplace_back(coordinates[2 * i], coordinates[2 * i + 1]);
+    data.matrix = matrix;
+    data.weight_type = Weight_type(header.weight_type);
+    data.optimal_value = header.optimal_value;
+    return data;
+}
+
+void File_manager::write_matrix_cache(const string& path, uint64_t source_hash, uint64_t source_size, const Instance& data) {
+    const Distance& matrix = *data.matrix;
+    Matrix_cache_header header{};
+    memcpy(header.magic, "PEAMTX3", 8);
+    header.size = matrix.size();
+    header.stride = matrix.stride();
+    header.weight_type = int32_t(data.weight_type);
+    header.optimal_value = data.optimal_value;
+    header.source_hash = source_hash;
+    header.source_size = source_size;
+    header.coordinate_count = data.coordinates.size();
+    header.weight_size = matrix.weight_size();
+
+    size_t coordinates_bytes = data.coordinates.size() * sizeof(pair<double, double>);
+    size_t padding = (Distance_matrix::cache_line - (sizeof(header) + coordinates_bytes) % Distance_matrix::cache_line) % Distance_matrix::cache_line;
+    string temporary_path = path + "." + to_string(random_device()()) + ".tmp";
+    ofstream file(temporary_path, ios::binary | ios::trunc);
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(data.coordinates.data()), streamsize(coordinates_bytes));
+    file.write(string(padding, '\0').data(), streamsize(padding));
+    file.write(static_cast<const char*>(matrix.values()), streamsize(matrix.bytes()));
+    file.close();
+
+    if(!file) remove(temporary_path.c_str());
+    else if(rename(temporary_path.c_str(), path.c_str()) != 0) {
+        remove(path.c_str());
+        if(rename(temporary_path.c_str(), path.c_str()) != 0) remove(temporary_path.c_str());
+    }
+}
+
+Instance File_manager::read_custom_file(const char* cursor, const char* end, bool implicit_distances) {
+    Instance data;
+    int type;
+    int size;
+
+    if(!next_int(cursor, end, type) || !next_int(cursor, end, size) || size <= 0) return data;
+
+    if(type == 0) {
+        shared_ptr<Distance_matrix> matrix = make_shared<Distance_matrix>(size);
+        data.matrix = matrix;
+        for(int i = 0; i < size; i++) {
+            const char* line_end = find_line_end(cursor, end);
+            int* row = matrix->row(i);
+            for(int j = 0; j < size && next_int(cursor, line_end, row[j]); j++);
+            cursor = line_end;
+        }
+    } else if(type == 1) {
+        for(int i = 0; i < size; i++) {
+            double latitude;
+            double longitude;
+            if(!next_double(cursor, end, latitude) || !next_double(cursor, end, longitude)) return Instance{};
+            data.coordinates.emplace_back(latitude, longitude);
+        }
+        if(implicit_distances) data.matrix = make_shared<Implicit_distance>(data.coordinates);
+        else data.matrix = Haversine_builder(data.coordinates).build();
+        data.weight_type = Weight_type::haversine;
+    } else return data;
+
+    next_int(cursor, end, data.optimal_value);
+    return data;
+}
+
+Instance File_manager::read_tsplib_file(const char* cursor, const char* end) {
+    Instance data;
+    int size = 0;
+    string weight_type = "EXPLICIT";
+    string weight_format = "FULL_MATRIX";
+    vector<pair<double, double>> coordinates;
+
+    while(cursor != end) {
+        string line = next_line(cursor, end);
+        size_t separator = line.find(':');
+        string key = line.substr(0, separator);
+        string value = separator == string::npos ? "" : line.substr(separator + 1);
+        key.erase(key.find_last_not_of(" \t") + 1);
+        value.erase(0, value.find_first_not_of(" \t"));
+        value.erase(value.find_last_not_of(" \t") + 1);
+
+        if(key == "DIMENSION") {
+            const char* value_cursor = value.data();
+            if(!next_int(value_cursor, value.data() + value.size(), size) || size <= 0) return Instance{};
+        }
+        else if(key == "EDGE_WEIGHT_TYPE") weight_type = value;
+        else if(key == "EDGE_WEIGHT_FORMAT") weight_format = value;
+        else if(key == "NODE_COORD_SECTION" || key == "DISPLAY_DATA_SECTION") {
+            vector<pair<double, double>> section(size);
             for(int i = 0; i < size; i++) {
-                getline(file, line);
-                stringstream ss(line);
-                vector<double> row;
-                float number;
-                while(ss >> number) row.push_back(number);
-                buffer.push_back(row);
+                int node;
+                if(!next_int(cursor, end, node) || !next_double(cursor, end, section[i].first) || !next_double(cursor, end, section[i].second)) return Instance{};
             }
-            matrix = set_matrix(buffer);
-        }
-        getline(file, line);
-        data.second = stoi(line);
+            if(key == "NODE_COORD_SECTION") coordinates = std::move(section);
+            else if(coordinates.empty()) data.coordinates = std::move(section);
+        } else if(key == "EDGE_WEIGHT_SECTION") {
+            if(size <= 0) return Instance{};
+            shared_ptr<Distance_matrix> matrix = make_shared<Distance_matrix>(size);
+            data.matrix = matrix;
+            if(!read_explicit_weights(cursor, end, weight_format, *matrix)) return Instance{};
+        } else if(key == "EOF") break;
     }
 
-    file.close();
+    if(weight_type != "EXPLICIT") {
+        Weight_type type = Weight_type::unsupported;
+        if(weight_type == "EUC_2D") type = Weight_type::euclidean;
+        else if(weight_type == "CEIL_2D") type = Weight_type::ceiling;
+        else if(weight_type == "ATT") type = Weight_type::pseudo_euclidean;
+        else if(weight_type == "GEO") type = Weight_type::geographical;
+        if(type == Weight_type::unsupported || coordinates.size() != size || size <= 0) return Instance{};
+
+        data.coordinates = coordinates;
+        data.weight_type = type;
+        data.matrix = set_tsplib_matrix(std::move(coordinates), type);
+    }
 
-    data.first = matrix;
     return data;
 }
 
-vector<vector<int>> File_manager::set_matrix(vector<vector<double>> buffer) {
-    vector<vector<int>> matrix;
-    vector<int> row;
+shared_ptr<Distance> File_manager::compact_matrix(const shared_ptr<Distance_matrix>& matrix) {
+    int max_weight = 0;
 
-    for(int i = 0; i < buffer.size(); i++) {
-        for(int j = 0; j < buffer.size(); j++) {
-            if(i == j) row.push_back(-1);
-            else row.push_back(static_cast<int>(round((haversine(buffer[i][0], buffer[i][1], buffer[j][0], buffer[j][1])))));
+    for(int i = 0; i < matrix->size(); i++) {
+        const int32_t* row = matrix->row(i);
+        for(int j = 0; j < matrix->size(); j++) {
+            if(row[j] < -1) return matrix;
+            max_weight = max(max_weight, int(row[j]));
         }
-        matrix.push_back(row);
-        row.clear();
     }
+    if(max_weight < UINT8_MAX) return narrow_matrix<uint8_t>(*matrix);
+    if(max_weight < UINT16_MAX) return narrow_matrix<uint16_t>(*matrix);
     return matrix;
 }
 
-double File_manager::haversine(double lat1, double lon1, double lat2, double lon2) {
-    const double rad = 6371;
-    double dLat = (lat2 - lat1) * M_PI / 180.0;
-    double dLon = (lon2 - lon1) * M_PI / 180.0;
+template<typename Weight>
+shared_ptr<Distance> File_manager::narrow_matrix(const Distance_matrix& matrix) {
+    shared_ptr<Basic_distance_matrix<Weight>> narrow = make_shared<Basic_distance_matrix<Weight>>(matrix.size());
+
+    for(int i = 0; i < matrix.size(); i++) {
+        const int32_t* row = matrix.row(i);
+        Weight* narrow_row = narrow->row(i);
+        for(int j = 0; j < matrix.size(); j++) narrow_row[j] = Basic_distance_matrix<Weight>::encode(row[j]);
+    }
+    return narrow;
+}
+
+bool File_manager::read_explicit_weights(const char*& cursor, const char* end, const string& format, Distance_matrix& matrix) {
+    int size = matrix.size();
+    bool symmetric = format != "FULL_MATRIX";
+
+    if(format != "FULL_MATRIX" && format != "UPPER_ROW" && format != "UPPER_DIAG_ROW" && format != "LOWER_ROW" && format != "LOWER_DIAG_ROW") return false;
+
+    for(int i = 0; i < size; i++) {
+        int first = 0;
+        int last = size;
+        if(format == "UPPER_ROW") first = i + 1;
+        else if(format == "UPPER_DIAG_ROW") first = i;
+        else if(format == "LOWER_ROW") last = i;
+        else if(format == "LOWER_DIAG_ROW") last = i + 1;
+
+        int* row = matrix.row(i);
+        for(int j = first; j < last; j++) {
+            if(!next_int(cursor, end, row[j])) return false;
+            if(symmetric) matrix.row(j)[i] = row[j];
+        }
+    }
+    for(int i = 0; i < size; i++) matrix.row(i)[i] = -1;
+    return true;
+}
+
+shared_ptr<Distance_matrix> File_manager::set_tsplib_matrix(vector<pair<double, double>> coordinates, Weight_type weight_type) {
+    shared_ptr<Distance_matrix> matrix = make_shared<Distance_matrix>(coordinates.size());
 
-    lat1 = (lat1) * M_PI / 180.0;
-    lat2 = (lat2) * M_PI / 180.0;
+    if(weight_type == Weight_type::geographical) {
+        for(auto& coordinate : coordinates) {
+            for(double* value : {&coordinate.first, &coordinate.second}) {
+                double degrees = trunc(*value);
+                *value = 3.141592 * (degrees + 5.0 * (*value - degrees) / 3.0) / 180.0;
+            }
+        }
+    }
 
-    double sq = pow(sin(dLat / 2), 2) + pow(sin(dLon / 2), 2) * cos(lat1) * cos(lat2);
-    return 2 * rad * asin(sqrt(sq));
+    for(int i = 0; i < coordinates.size(); i++) {
+        int* row = matrix->row(i);
+        row[i] = -1;
+        for(int j = i + 1; j < coordinates.size(); j++) {
+            row[j] = tsplib_distance(weight_type, coordinates[i], coordinates[j]);
+            matrix->row(j)[i] = row[j];
+        }
+    }
+    return matrix;
 }
 
-void File_manager::write_to_file(const string& data_name, const std::string& results_name, int optimal_value, vector<chrono::duration<double, micro>> total_times,
-                                 chrono::duration<double, micro> time, float absolute_error, float relative_error) {
+int File_manager::tsplib_distance(Weight_type weight_type, const pair<double, double>& a, const pair<double, double>& b) {
+    double dx = a.first - b.first;
+    double dy = a.second - b.second;
+
+    if(weight_type == Weight_type::euclidean) return int(sqrt(dx * dx + dy * dy) + 0.5);
+    if(weight_type == Weight_type::ceiling) return int(ceil(sqrt(dx * dx + dy * dy)));
+    if(weight_type == Weight_type::pseudo_euclidean) {
+        double distance = sqrt((dx * dx + dy * dy) / 10.0);
+        int rounded = int(distance + 0.5);
+        return rounded < distance ? rounded + 1 : rounded;
+    }
+
+    const double radius = 6378.388;
+    double q1 = cos(a.second - b.second);
+    double q2 = cos(a.first - b.first);
+    double q3 = cos(a.first + b.first);
+    return int(radius * acos(0.5 * ((1.0 + q1) * q2 - (1.0 - q1) * q3)) + 1.0);
+}
+
+template<typename Integer>
+bool File_manager::next_int(const char*& cursor, const char* end, Integer& value) {
+    while(cursor != end && isspace(static_cast<unsigned char>(*cursor))) cursor++;
+    if(cursor != end && *cursor == '+') cursor++;
+
+    from_chars_result result = from_chars(cursor, end, value);
+    if(result.ec != errc()) return false;
+    cursor = result.ptr;
+    if(cursor != end && *cursor == '.') {
+        double fraction;
+        from_chars_result fraction_result = from_chars(cursor, end, fraction);
+        if(fraction_result.ec == errc()) cursor = fraction_result.ptr;
+    }
+    return true;
+}
+
+bool File_manager::next_double(const char*& cursor, const char* end, double& value) {
+    while(cursor != end && isspace(static_cast<unsigned char>(*cursor))) cursor++;
+    if(cursor != end && *cursor == '+') cursor++;
+
+    from_chars_result result = from_chars(cursor, end, value);
+    if(result.ec != errc()) return false;
+    cursor = result.ptr;
+    return true;
+}
+
+const char* File_manager::find_line_end(const char*& cursor, const char* end) {
+    while(cursor != end && isspace(static_cast<unsigned char>(*cursor))) cursor++;
+    const char* line_end = static_cast<const char*>(memchr(cursor, '\n', end - cursor));
+    return line_end == nullptr ? end : line_end;
+}
+
+string File_manager::next_line(const char*& cursor, const char* end) {
+    const char* line_end = find_line_end(cursor, end);
+    string line(cursor, line_end);
+    cursor = line_end;
+    if(!line.empty() && line.back() == '\r') line.pop_back();
+    return line;
+}
+
+void File_manager::write_to_file(const string& data_name, const std::string& results_name, Cost optimal_value, long long lower_bound, vector<chrono::duration<double, micro>> total_times,
+                                 vector<chrono::duration<double, micro>> total_cpu_times, chrono::duration<double, micro> time, float absolute_error, float relative_error) {
 
     ofstream file(results_name, ios::trunc);
 
     file << "Nazwa instancji," << data_name << "\n";
-    file << "Wynik optymalny," << optimal_value << "\n";
+    if(optimal_value >= 0) file << "Wynik optymalny," << optimal_value << "\n";
+    else file << "Wynik optymalny,nieznany" << "\n";
+    if(lower_bound >= 0) file << "Dolne ograniczenie (problem przydzialu)," << lower_bound << "\n";
     file << "Sredni czas wykonania," << time.count() << "\n";
-    file << "Sredni blad bezwzgledny," << absolute_error << "\n";
-    file << "Sredni blad wzgledny," << relative_error << "\n";
-    file << "Sredni blad wzgledny(w procentach)," << relative_error * 100 << "%" "\n";
-    file << "Numer proby,Czas wykonania" << "\n";
+    if(optimal_value >= 0) {
+        file << "Sredni blad bezwzgledny," << absolute_error << "\n";
+        file << "Sredni blad wzgledny," << relative_error << "\n";
+        file << "Sredni blad wzgledny(w procentach)," << relative_error * 100 << "%" "\n";
+    }
+    file << "Numer proby,Czas wykonania,Czas procesora" << "\n";
 
     for(int i = 0; i < total_times.size(); i++) {
-        file << i + 1 << "," << total_times[i].count() << "\n";
+        file << i + 1 << "," << total_times[i].count() << "," << total_cpu_times[i].count() << "\n";
+    }
+
+    file.close();
+}
+void File_manager::write_trace(const string& results_name, int repetition, const Convergence_trace& trace) {
+    size_t extension = results_name.find_last_of('.');
+    string trace_name = results_name.substr(0, extension) + "_przebieg_" + to_string(repetition) + (extension == string::npos ? ".csv" : results_name.substr(extension));
+    ofstream file(trace_name, ios::trunc);
+
+    file << "Iteracja,Czas [ns],Dlugosc biezaca,Dlugosc najlepsza,Restart" << "\n";
+    for(int i = 0; i < trace.size(); i++) {
+        const Trace_point& point = trace[i];
+        file << point.iteration << "," << point.elapsed_ns << "," << point.current_cost << "," << point.best_cost << "," << point.restart << "\n";
     }
 
     file.close();
-}
\ No newline at end of file
+}
@@ -1,24 +1,64 @@
 #ifndef FILE_MANAGER_HPP
 #define FILE_MANAGER_HPP
+#include "Distance_matrix.hpp"
+#include "Convergence_trace.hpp"
 #include <string>
 #include <vector>
 #include <chrono>
 #include <cmath>
-#define M_PI 3.14159265358979323846
+#include <memory>
+#include <cstdint>
 
 using namespace std;
 
+enum class Weight_type { explicit_weights, haversine, euclidean, ceiling, pseudo_euclidean, geographical, unsupported };
+
+struct Instance {
+    shared_ptr<Distance> matrix;
+    Weight_type weight_type = Weight_type::explicit_weights;
+    Cost optimal_value = -1;
+    vector<pair<double, double>> coordinates;
+};
+
 class File_manager {
 
 public:
     static tuple<vector<string>, vector<int>, vector<float>> read_config_file(const string& path);
-    pair<vector<vector<int>>, int> read_data_file(const string& path);
-    void write_to_file(const string& data_name, const string& results_name, int optimal_value, vector<chrono::duration<double,
-            micro>> total_times, chrono::duration<double, micro> time, float absolute_error, float relative_error);
+    Instance read_data_file(const string& path, bool use_cache = false, bool implicit_distances = false);
+    void write_to_file(const string& data_name, const string& results_name, Cost optimal_value, long long lower_bound, vector<chrono::duration<double,
+            micro>> total_times, vector<chrono::duration<double, micro>> total_cpu_times, chrono::duration<double, micro> time,
+            float absolute_error, float relative_error);
+    static void write_trace(const string& results_name, int repetition, const Convergence_trace& trace);
 
 private:
-    vector<vector<int>> set_matrix(vector<vector<double>> buffer);
-    static double haversine(double lat1, double lon1, double lat2, double lon2);
+    struct Matrix_cache_header {
+        char magic[8];
+        int32_t size;
+        int32_t stride;
+        int32_t weight_type;
+        int32_t weight_size;
+        int64_t optimal_value;
+        uint64_t source_hash;
+        uint64_t source_size;
+        uint64_t coordinate_count;
+        char padding[8];
+    };
+
+    static uint64_t hash_source(const char* data, size_t size);
+    static Instance read_matrix_cache(const string& path, uint64_t source_hash, uint64_t source_size);
+    static void write_matrix_cache(const string& path, uint64_t source_hash, uint64_t source_size, const Instance& data);
+    Instance read_custom_file(const char* cursor, const char* end, bool implicit_distances);
+    static Instance read_tsplib_file(const char* cursor, const char* end);
+    static Instance read_optimal_value(const string& path, Instance& data);
+    static shared_ptr<Distance> compact_matrix(const shared_ptr<Distance_matrix>& matrix);
+    template<typename Weight> static shared_ptr<Distance> narrow_matrix(const Distance_matrix& matrix);
+    static bool read_explicit_weights(const char*& cursor, const char* end, const string& format, Distance_matrix& matrix);
+    static shared_ptr<Distance_matrix> set_tsplib_matrix(vector<pair<double, double>> coordinates, Weight_type weight_type);
+    static int tsplib_distance(Weight_type weight_type, const pair<double, double>& a, const pair<double, double>& b);
+    template<typename Integer> static bool next_int(const char*& cursor, const char* end, Integer& value);
+    static bool next_double(const char*& cursor, const char* end, double& value);
+    static const char* find_line_end(const char*& cursor, const char* end);
+    static string next_line(const char*& cursor, const char* end);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "Haversine_builder.hpp"
+#include "Thread_pool.hpp"
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HAVERSINE_AVX2
+#endif
+
+static constexpr double pi = 3.14159265358979323846;
+
+Haversine_builder::Haversine_builder(const vector<pair<double, double>>& coordinates) : coordinates(coordinates) {
+    for(const auto& coordinate : coordinates) {
+        double latitude = coordinate.first * pi / 180.0;
+        double longitude = coordinate.second * pi / 180.0;
+        sin_half_latitude.push_back(sin(latitude / 2));
+        cos_half_latitude.push_back(cos(latitude / 2));
+        sin_half_longitude.push_back(sin(longitude / 2));
+        cos_half_longitude.push_back(cos(longitude / 2));
+        cos_latitude.push_back(cos(latitude));
+    }
+}
+
+shared_ptr<Distance_matrix> Haversine_builder::build(int threads) const {
+    shared_ptr<Distance_matrix> matrix = make_shared<Distance_matrix>(coordinates.size());
+    int size = coordinates.size();
+    bool use_avx2 = false;
+#ifdef HAVERSINE_AVX2
+    use_avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if(threads <= 0) threads = max(1, int(thread::hardware_concurrency()));
+    threads = max(1, min(threads, size / 64));
+
+    auto fill_rows = [&](int worker) {
+        for(int i = worker; i < size; i += threads) fill_row(*matrix, i, use_avx2);
+    };
+    if(threads == 1) fill_rows(0);
+    else Thread_pool(threads).run(fill_rows);
+    return matrix;
+}
+
+void Haversine_builder::fill_row(Distance_matrix& matrix, int i, bool use_avx2) const {
+    int* row = matrix.row(i);
+    int j = i + 1;
+    row[i] = -1;
+
+#ifdef HAVERSINE_AVX2
+    if(use_avx2) j = fill_row_avx2(matrix, i);
+#endif
+    for(; j < coordinates.size(); j++) {
+        row[j] = distance(i, j);
+        matrix.row(j)[i] = row[j];
+    }
+}
+
+double Haversine_builder::haversine_argument(double sin_a, double cos_a, double sin_b, double cos_b) {
+    return sin_b * cos_a - cos_b * sin_a;
+}
+
+int Haversine_builder::distance(int i, int j) const {
+    if(j < i) swap(i, j);
+    double sin_latitude = haversine_argument(sin_half_latitude[i], cos_half_latitude[i], sin_half_latitude[j], cos_half_latitude[j]);
+    double sin_longitude = haversine_argument(sin_half_longitude[i], cos_half_longitude[i], sin_half_longitude[j], cos_half_longitude[j]);
+    double sq = sin_latitude * sin_latitude + sin_longitude * sin_longitude * cos_latitude[i] * cos_latitude[j];
+    return rounded_distance(i, j, 2 * radius * asin(sqrt(min(max(sq, 0.0), 1.0))));
+}
+
+int Haversine_builder::rounded_distance(int i, int j, double distance) const {
+    double fraction = distance - floor(distance);
+    if(fabs(fraction - 0.5) < rounding_margin) {
+        distance = haversine(coordinates[i].first, coordinates[i].second, coordinates[j].first, coordinates[j].second);
+    }
+    return static_cast<int>(round(distance));
+}
+
+#ifdef HAVERSINE_AVX2
+static __attribute__((target("avx2"))) __m256d polynomial(__m256d x, const double* coefficients, int count) {
+    __m256d result = _mm256_set1_pd(coefficients[0]);
+    for(int k = 1; k < count; k++) result = _mm256_add_pd(_mm256_mul_pd(result, x), _mm256_set1_pd(coefficients[k]));
+    return result;
+}
+
+static __attribute__((target("avx2"))) __m256d asin_avx2(__m256d x) {
+    static const double p[] = {4.253011369004428248960E-3, -6.019598008014123785661E-1, 5.444622390564711410273E0,
+                               -1.626247967210700244449E1, 1.956261983317594739197E1, -8.198089802484824371615E0};
+    static const double q[] = {1.0, -1.474091372988853791896E1, 7.049610280856842141659E1, -1.471791292232726029859E2,
+                               1.395105614657485689735E2, -4.918853881490881290110E1};
+    static const double r[] = {2.967721961301243206100E-3, -5.634242780008963776856E-1, 6.968710824104713396794E0,
+                               -2.556901049652824852289E1, 2.853665548261061424989E1};
+    static const double s[] = {1.0, -2.194779531642920639778E1, 1.470656354026814941758E2, -3.838770957603691357202E2,
+                               3.424398657913078477438E2};
+    const __m256d quarter_pi = _mm256_set1_pd(pi / 4);
+    const __m256d more_bits = _mm256_set1_pd(6.123233995736765886130E-17);
+
+    __m256d squared = _mm256_mul_pd(x, x);
+    __m256d small = _mm256_div_pd(_mm256_mul_pd(squared, polynomial(squared, p, 6)), polynomial(squared, q, 6));
+    small = _mm256_add_pd(_mm256_mul_pd(x, small), x);
+
+    __m256d complement = _mm256_sub_pd(_mm256_set1_pd(1.0), x);
+    __m256d correction = _mm256_div_pd(_mm256_mul_pd(complement, polynomial(complement, r, 5)), polynomial(complement, s, 5));
+    __m256d root = _mm256_sqrt_pd(_mm256_add_pd(complement, complement));
+    __m256d large = _mm256_sub_pd(quarter_pi, root);
+    large = _mm256_sub_pd(large, _mm256_sub_pd(_mm256_mul_pd(root, correction), more_bits));
+    large = _mm256_add_pd(large, quarter_pi);
+
+    return _mm256_blendv_pd(small, large, _mm256_cmp_pd(x, _mm256_set1_pd(0.625), _CMP_GT_OQ));
+}
+
+int Haversine_builder::fill_row_avx2(Distance_matrix& matrix, int i) const {
+    int* row = matrix.row(i);
+    int size = coordinates.size();
+    int j = i + 1;
+    alignas(32) double distances[4];
+
+    __m256d sin_latitude_i = _mm256_set1_pd(sin_half_latitude[i]);
+    __m256d cos_latitude_i = _mm256_set1_pd(cos_half_latitude[i]);
+    __m256d sin_longitude_i = _mm256_set1_pd(sin_half_longitude[i]);
+    __m256d cos_longitude_i = _mm256_set1_pd(cos_half_longitude[i]);
+    __m256d cos_i = _mm256_set1_pd(cos_latitude[i]);
+    __m256d diameter = _mm256_set1_pd(2 * radius);
+
+    for(; j + 4 <= size; j += 4) {
+        __m256d sin_latitude = _mm256_sub_pd(_mm256_mul_pd(_mm256_loadu_pd(&sin_half_latitude[j]), cos_latitude_i),
+                                             _mm256_mul_pd(_mm256_loadu_pd(&cos_half_latitude[j]), sin_latitude_i));
+        __m256d sin_longitude = _mm256_sub_pd(_mm256_mul_pd(_mm256_loadu_pd(&sin_half_longitude[j]), cos_longitude_i),
+                                              _mm256_mul_pd(_mm256_loadu_pd(&cos_half_longitude[j]), sin_longitude_i));
+        __m256d sq = _mm256_add_pd(_mm256_mul_pd(sin_latitude, sin_latitude),
+                                   _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(sin_longitude, sin_longitude), cos_i), _mm256_loadu_pd(&cos_latitude[j])));
+        sq = _mm256_min_pd(_mm256_max_pd(sq, _mm256_setzero_pd()), _mm256_set1_pd(1.0));
+        _mm256_store_pd(distances, _mm256_mul_pd(diameter, asin_avx2(_mm256_sqrt_pd(sq))));
+
+        for(int k = 0; k < 4; k++) {
+            row[j + k] = rounded_distance(i, j + k, distances[k]);
+            matrix.row(j + k)[i] = row[j + k];
+        }
+    }
+    return j;
+}
+#endif
+
+double Haversine_builder::haversine(double lat1, double lon1, double lat2, double lon2) {
+    double dLat = (lat2 - lat1) * pi / 180.0;
+    double dLon = (lon2 - lon1) * pi / 180.0;
+
+    lat1 = (lat1) * pi / 180.0;
+    lat2 = (lat2) * pi / 180.0;
+
+    double sq = pow(sin(dLat / 2), 2) + pow(sin(dLon / 2), 2) * cos(lat1) * cos(lat2);
+    return 2 * radius * asin(sqrt(sq));
+}
@@ -0,0 +1,37 @@
+#ifndef HAVERSINE_BUILDER_HPP
+#define HAVERSINE_BUILDER_HPP
+#include "Distance_matrix.hpp"
+#include <vector>
+#include <memory>
+
+using namespace std;
+
+class Haversine_builder {
+
+public:
+    explicit Haversine_builder(const vector<pair<double, double>>& coordinates);
+
+    shared_ptr<Distance_matrix> build(int threads = 0) const;
+    int distance(int i, int j) const;
+    static double haversine(double lat1, double lon1, double lat2, double lon2);
+
+private:
+    static constexpr double radius = 6371;
+    static constexpr double rounding_margin = 1e-6;
+
+    const vector<pair<double, double>>& coordinates;
+    vector<double, Aligned_allocator<double, Distance_matrix::cache_line>> sin_half_latitude;
+    vector<double, Aligned_allocator<double, Distance_matrix::cache_line>> cos_half_latitude;
+    vector<double, Aligned_allocator<double, Distance_matrix::cache_line>> sin_half_longitude;
+    vector<double, Aligned_allocator<double, Distance_matrix::cache_line>> cos_half_longitude;
+    vector<double, Aligned_allocator<double, Distance_matrix::cache_line>> cos_latitude;
+
+    void fill_row(Distance_matrix& matrix, int i, bool use_avx2) const;
+    int rounded_distance(int i, int j, double distance) const;
+    static double haversine_argument(double sin_a, double cos_a, double sin_b, double cos_b);
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __attribute__((target("avx2"))) int fill_row_avx2(Distance_matrix& matrix, int i) const;
+#endif
+};
+
+#endif
@@ -0,0 +1,106 @@
+#include "Implicit_distance.hpp"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+Implicit_distance::Implicit_distance(vector<pair<double, double>> coordinates) : coordinates(std::move(coordinates)), builder(this -> coordinates) {
+    int size = this -> coordinates.size();
+    matrix_size = size;
+    cache.reset(new atomic<uint64_t>[size_t(size) * cache_slots]);
+    for(size_t i = 0; i < size_t(size) * cache_slots; i++) cache[i].store(0, memory_order_relaxed);
+
+    for(const auto& coordinate : this -> coordinates) {
+        double latitude = coordinate.first * 3.14159265358979323846 / 180.0;
+        double longitude = coordinate.second * 3.14159265358979323846 / 180.0;
+        points.push_back({cos(latitude) * cos(longitude), cos(latitude) * sin(longitude), sin(latitude)});
+    }
+
+    array<double, 3> extent{};
+    for(int axis = 0; axis < 3; axis++) {
+        auto bounds = minmax_element(points.begin(), points.end(), [axis](const array<double, 3>& a, const array<double, 3>& b) { return a[axis] < b[axis]; });
+        origin[axis] = size > 0 ? (*bounds.first)[axis] : 0;
+        extent[axis] = size > 0 ? (*bounds.second)[axis] - origin[axis] : 0;
+    }
+    array<double, 3> sorted_extent = extent;
+    sort(sorted_extent.begin(), sorted_extent.end());
+    cell_size = max(1e-9, sqrt(max(sorted_extent[1] * sorted_extent[2], sorted_extent[2] * sorted_extent[2] / max(size, 1)) / max(size / 2, 1)));
+    for(int axis = 0; axis < 3; axis++) cells_per_axis[axis] = int(extent[axis] / cell_size) + 1;
+    vector<pair<long long, int>> cells;
+    for(int i = 0; i < size; i++) {
+        array<int, 3> cell = cell_of(i);
+        cells.emplace_back(cell_key(cell[0], cell[1], cell[2]), i);
+    }
+    sort(cells.begin(), cells.end());
+    for(const auto& cell : cells) {
+        cell_keys.push_back(cell.first);
+        cell_cities.push_back(cell.second);
+    }
+}
+
+int Implicit_distance::compute(int from, int to) const {
+    if(from == to) return -1;
+
+    atomic<uint64_t>& from_slot = cache[size_t(from) * cache_slots + cache_slot(to)];
+    uint64_t entry = from_slot.load(memory_order_relaxed);
+    if(entry >> 32 == uint64_t(to) + 1) return int(uint32_t(entry));
+
+    int distance = builder.distance(from, to);
+    from_slot.store((uint64_t(to) + 1) << 32 | uint32_t(distance), memory_order_relaxed);
+    cache[size_t(to) * cache_slots + cache_slot(from)].store((uint64_t(from) + 1) << 32 | uint32_t(distance), memory_order_relaxed);
+    return distance;
+}
+
+void Implicit_distance::nearest_neighbours(int city, int count, vector<int>& neighbours) const {
+    vector<pair<double, int>> found;
+    array<int, 3> center = cell_of(city);
+    count = min(count, matrix_size - 1);
+    neighbours.clear();
+    if(count <= 0) return;
+
+    int max_radius = *max_element(cells_per_axis.begin(), cells_per_axis.end());
+
+    for(int radius = 0; radius <= max_radius; radius++) {
+        for(int dx = -radius; dx <= radius; dx++) {
+            for(int dy = -radius; dy <= radius; dy++) {
+                for(int dz = -radius; dz <= radius; dz++) {
+                    if(max({abs(dx), abs(dy), abs(dz)}) != radius) continue;
+                    int x = center[0] + dx;
+                    int y = center[1] + dy;
+                    int z = center[2] + dz;
+                    if(x < 0 || y < 0 || z < 0 || x >= cells_per_axis[0] || y >= cells_per_axis[1] || z >= cells_per_axis[2]) continue;
+
+                    long long key = cell_key(x, y, z);
+                    auto range = equal_range(cell_keys.begin(), cell_keys.end(), key);
+                    for(auto it = range.first; it != range.second; it++) {
+                        int other = cell_cities[it - cell_keys.begin()];
+                        if(other == city) continue;
+                        double chord = 0;
+                        for(int axis = 0; axis < 3; axis++) chord += (points[city][axis] - points[other][axis]) * (points[city][axis] - points[other][axis]);
+                        found.emplace_back(sqrt(chord), other);
+                    }
+                }
+            }
+        }
+        if(found.size() < count) continue;
+
+        nth_element(found.begin(), found.begin() + count - 1, found.end());
+        double kth_distance = 2 * 6371 * asin(min(1.0, found[count - 1].first / 2)) + 1;
+        if(2 * sin(min(kth_distance / (2 * 6371), 3.14159265358979323846 / 2)) < radius * cell_size) break;
+    }
+
+    vector<pair<int, int>> candidates;
+    for(const auto& point : found) candidates.emplace_back(at(city, point.second), point.second);
+    count = min(count, int(candidates.size()));
+    partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+    for(int k = 0; k < count; k++) neighbours.push_back(candidates[k].second);
+}
+
+array<int, 3> Implicit_distance::cell_of(int city) const {
+    array<int, 3> cell{};
+    for(int axis = 0; axis < 3; axis++) cell[axis] = min(cells_per_axis[axis] - 1, max(0, int((points[city][axis] - origin[axis]) / cell_size)));
+    return cell;
+}
+
+long long Implicit_distance::cell_key(int x, int y, int z) const {
+    return (static_cast<long long>(x) * cells_per_axis[1] + y) * cells_per_axis[2] + z;
+}
@@ -0,0 +1,42 @@
+#ifndef IMPLICIT_DISTANCE_HPP
+#define IMPLICIT_DISTANCE_HPP
+#include "Distance.hpp"
+#include "Haversine_builder.hpp"
+#include <vector>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+using namespace std;
+
+class Implicit_distance : public Distance {
+
+public:
+    explicit Implicit_distance(vector<pair<double, double>> coordinates);
+
+    void nearest_neighbours(int city, int count, vector<int>& neighbours) const override;
+
+protected:
+    int compute(int from, int to) const override;
+
+private:
+    static constexpr int cache_slots = 16;
+
+    vector<pair<double, double>> coordinates;
+    Haversine_builder builder;
+    unique_ptr<atomic<uint64_t>[]> cache;
+
+    vector<array<double, 3>> points;
+    double cell_size = 2;
+    array<double, 3> origin{};
+    array<int, 3> cells_per_axis{};
+    vector<long long> cell_keys;
+    vector<int> cell_cities;
+
+    array<int, 3> cell_of(int city) const;
+    long long cell_key(int x, int y, int z) const;
+    static int cache_slot(int to) { return int((uint32_t(to) * 2654435761u) >> 28); }
+};
+
+#endif
@@ -1,42 +1,113 @@
 #include "Main.hpp"
 #include <iostream>
+#include <atomic>
+#include <mutex>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <ctime>
+#endif
 
 using namespace std;
 
 void Main::run() {
-    pair<vector<int>, int> results;
-    vector<chrono::duration<double, micro>> times;
-    pair<vector<vector<int>>, int> data;
-    chrono::duration<double, micro> time{};
-    chrono::high_resolution_clock::time_point t0;
+    Instance data;
+    mutex print_mutex;
+    atomic<int> next_repetition{0};
 
     tuple<vector<string>, vector<int>, vector<float>> config_data = File_manager::read_config_file(config_path);
-    assign_parameters(get<0>(config_data), get<1>(config_data), get<2>(config_data));
-    data = file_manager.read_data_file(data_path);
-    matrix = data.first;
-    optimal_value = data.second;
+    if(!assign_parameters(get<0>(config_data), get<1>(config_data), get<2>(config_data))) return;
+    data = file_manager.read_data_file(data_path, matrix_cache == 1, implicit_distances == 1);
+    if(!data.matrix) {
+        cout << "Nie udalo sie wczytac pliku z danymi: " << data_path << endl;
+        return;
+    }
+    matrix = data.matrix;
+    optimal_value = data.optimal_value;
 
-    if(progress_indicator == 0) print_info();
+    Assignment_result assignment;
+    if(upper_bound == 6) assignment = Assignment::solve(*matrix);
+    lower_bound = assignment.value;
+    budget.milliseconds = milliseconds >= 0 ? milliseconds : minutes >= 0 ? minutes * 60000LL : -1;
+    budget.iterations = max_iterations;
+    budget.target_cost = target_cost >= 0 ? target_cost : optimal_value;
+    search_parameters = Search_parameters{end_factor, restart_factor, tenure_factor, list_factor, upper_bound, solution_generator, budget};
+    if(seed == 0) seed = (uint64_t(random_device()()) << 32) | random_device()();
 
-    tsp.set_matrix(matrix);
+    Thread_pool runners(min(parallel_repetitions, repetitions));
+    solvers.resize(runners.size() * islands);
+    for(auto& solver : solvers) {
+        solver.set_matrix(matrix, candidates);
+        solver.set_coordinates(data.coordinates);
+        solver.set_assignment(assignment.successors);
+        solver.set_threads(threads);
+        solver.set_dont_look_bits(dont_look_bits == 1);
+        solver.set_segment_length(segment_length);
+        solver.set_beam_width(beam_width);
+        solver.set_trace(trace_capacity, trace_interval);
+        solver.set_two_level_threshold(two_level_threshold);
+    }
+    if(islands > 1) for(int i = 0; i < runners.size(); i++) island_pools.emplace_back(new Thread_pool(islands));
+    if(progress_indicator == 0) print_info();
+    total_times.assign(repetitions, chrono::duration<double, micro>::zero());
+    total_cpu_times.assign(repetitions, chrono::duration<double, micro>::zero());
 
     cout << "Zakonczono przygotowywanie" << endl;
     system("pause");
 
-    for(int i = 0; i < repetitions; i++) {
-        t0 = chrono::high_resolution_clock::now();
-        results = tsp.TS(end_factor, restart_factor, upper_bound, solution_generator, minutes, optimal_value, tenure_factor, list_factor);
-        time = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - t0);
-        print_partial_results(results, i + 1, time);
-    }
+    runners.run([&](int worker) {
+        for(int i = next_repetition++; i < repetitions; i = next_repetition++) {
+            chrono::duration<double, micro> cpu_time{};
+            chrono::high_resolution_clock::time_point t0 = chrono::high_resolution_clock::now();
+            pair<vector<int>, Cost> results = run_repetition(worker, i, cpu_time);
+            chrono::duration<double, micro> time = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - t0);
+
+            lock_guard<mutex> lock(print_mutex);
+            print_partial_results(results, i + 1, time, cpu_time);
+        }
+    });
 
     if(progress_indicator) print_info();
     print_total_results();
-    file_manager.write_to_file(data_path.substr(data_path.find_last_of('/') + 1), result_path, optimal_value, total_times,
+    file_manager.write_to_file(data_path.substr(data_path.find_last_of('/') + 1), result_path, optimal_value, lower_bound, total_times, total_cpu_times,
                                total_time/time_measurements, total_absolute_error/repetitions, total_relative_error/repetitions);
 }
 
-void Main::assign_parameters(vector<string> parameters_string, vector<int> parameters_int, vector<float> parameters_float) {
+pair<vector<int>, Cost> Main::run_repetition(int worker, int repetition, chrono::duration<double, micro>& cpu_time) {
+    if(islands == 1) {
+        chrono::duration<double, micro> cpu_t0 = thread_cpu_time();
+        solvers[worker].set_seed(seed, repetition);
+        pair<vector<int>, Cost> results = solvers[worker].TS(search_parameters);
+        cpu_time = thread_cpu_time() - cpu_t0;
+        if(trace_capacity > 0) File_manager::write_trace(result_path, repetition + 1, solvers[worker].get_trace());
+        return results;
+    }
+
+    Elite_pool elite_pool(max(4, islands), matrix->size() + 1);
+    vector<pair<vector<int>, Cost>> island_results(islands);
+    vector<chrono::duration<double, micro>> island_cpu_times(islands);
+
+    island_pools[worker]->run([&](int island) {
+        TSP& solver = solvers[worker * islands + island];
+        chrono::duration<double, micro> cpu_t0 = thread_cpu_time();
+        solver.set_seed(seed, repetition * islands + island);
+        solver.set_elite_pool(&elite_pool, exchange_interval);
+        island_results[island] = solver.TS(search_parameters);
+        solver.set_elite_pool(nullptr, exchange_interval);
+        island_cpu_times[island] = thread_cpu_time() - cpu_t0;
+    });
+
+    cpu_time = chrono::duration<double, micro>::zero();
+    for(const auto& island_cpu_time : island_cpu_times) cpu_time = cpu_time + island_cpu_time;
+    int best_island = min_element(island_results.begin(), island_results.end(), [](const pair<vector<int>, Cost>& a, const pair<vector<int>, Cost>& b) {
+        return a.second < b.second;
+    }) - island_results.begin();
+    if(trace_capacity > 0) File_manager::write_trace(result_path, repetition + 1, solvers[worker * islands + best_island].get_trace());
+    return island_results[best_island];
+}
+
+bool Main::assign_parameters(vector<string> parameters_string, vector<int> parameters_int, vector<float> parameters_float) {
     data_path = parameters_string[0];
     result_path = parameters_string[1];
     minutes = parameters_int[0];
@@ -44,25 +115,65 @@ void Main::assign_parameters(vector<string> parameters_string, vector<int> param
     upper_bound = parameters_int[2];
     repetitions = parameters_int[3];
     progress_indicator = parameters_int[4];
+    threads = parameters_int[5];
+    parallel_repetitions = parameters_int[6];
+    islands = max(1, parameters_int[7]);
+    exchange_interval = parameters_int[8];
+    candidates = parameters_int[9];
+    dont_look_bits = parameters_int[10];
+    segment_length = parameters_int[11];
+    beam_width = parameters_int[12];
+    seed = parameters_int[13];
+    milliseconds = parameters_int[14];
+    max_iterations = parameters_int[15];
+    target_cost = parameters_int[16];
+    trace_capacity = parameters_int[17];
+    trace_interval = parameters_int[18];
+    matrix_cache = parameters_int[19];
+    implicit_distances = parameters_int[20];
+    two_level_threshold = parameters_int[21];
     restart_factor = parameters_float[0];
     end_factor = parameters_float[1];
     tenure_factor = parameters_float[2];
     list_factor = parameters_float[3];
+
+    if(solution_generator < Swap_neighbourhood::type || solution_generator > Segment_neighbourhood::type) {
+        cout << "Nieznany sposob generowania rozwiazan w otoczeniu: " << solution_generator << " (dozwolone wartosci 1 - 4)" << endl;
+        return false;
+    }
+    return true;
 }
 
 void Main::print_info() {
 
     size_t position = data_path.find_last_of('/');
     cout << endl << "Plik zawierajacy dane problemu: " << data_path.substr(position + 1) << endl;
-    cout << "Wynik optymalny: " << optimal_value << endl;
+    if(optimal_value >= 0) cout << "Wynik optymalny: " << optimal_value << endl;
+    else cout << "Wynik optymalny: nieznany" << endl;
+    if(lower_bound >= 0) cout << "Dolne ograniczenie (problem przydzialu): " << lower_bound << endl;
     cout << "Wybrana metoda: Tabu Search" << endl;
+    cout << "Rozwiazanie poczatkowe: " << initial_solution_names[min(max(upper_bound, 0), 6)] << endl;
     cout << "Liczba powtorzen przeszukania: " << repetitions << endl;
-    if(minutes != INT_MAX) cout << "Maksymalny czas przeszukania: " << minutes << " min" << endl;
+    cout << "Ziarno generatora liczb losowych: " << seed << endl;
+    cout << "Liczba watkow przeszukiwania otoczenia: " << threads << endl;
+    cout << "Liczba rownoleglych powtorzen: " << parallel_repetitions << endl;
+    if(!matrix->is_dense()) cout << "Odleglosci liczone na zadanie (bez macierzy)" << endl;
+    else cout << "Rozmiar wagi w macierzy odleglosci: " << matrix->weight_size() << " B" << endl;
+    if(candidates > 0) cout << "Otoczenie granularne: " << candidates << " najblizszych sasiadow" << (dont_look_bits == 1 ? ", bity don't look" : "") << endl;
+    if(solvers[0].uses_two_level_list() && (solution_generator == Inversion_neighbourhood::type || solution_generator == Segment_neighbourhood::type)) {
+        cout << "Trasa jako lista dwupoziomowa" << endl;
+    }
+    if(islands > 1) cout << "Liczba wspolpracujacych wysp: " << islands << " (wymiana co " << exchange_interval << " iteracji)" << endl;
+    if(budget.milliseconds >= 60000 && budget.milliseconds % 60000 == 0) cout << "Maksymalny czas przeszukania: " << budget.milliseconds / 60000 << " min" << endl;
+    else if(budget.milliseconds >= 0) cout << "Maksymalny czas przeszukania: " << budget.milliseconds << " ms" << endl;
     else cout << "Brak ograniczenia czasowego" << endl;
+    if(budget.iterations >= 0) cout << "Maksymalna liczba iteracji: " << budget.iterations << endl;
+    if(trace_capacity > 0) cout << "Zapis przebiegu zbieznosci: bufor " << trace_capacity << " punktow, probkowanie co " << trace_interval << " iteracji" << endl;
+    if(budget.target_cost >= 0) cout << "Docelowa dlugosc sciezki: " << budget.target_cost << endl;
     cout << endl;
 }
 
-void Main::print_partial_results(pair<vector<int>, int> results, int repetition, chrono::duration<double, micro> time) {
+void Main::print_partial_results(pair<vector<int>, Cost> results, int repetition, chrono::duration<double, micro> time, chrono::duration<double, micro> cpu_time) {
     float absolute_error;
     float relative_error;
 
@@ -78,18 +189,22 @@ void Main::print_partial_results(pair<vector<int>, int> results, int repetition,
     else if(time.count() >= 1000000) cout << chrono::duration<double>(time).count() << " s" << endl;
     else if(time.count() >= 1000) cout << chrono::duration<double, milli>(time).count() << " ms" << endl;
     else cout << time.count() << " micro" << endl;
+    cout << "Czas procesora dla rozwiazania " << repetition << ": " << chrono::duration<double, milli>(cpu_time).count() << " ms" << endl;
     cout.unsetf(ios::fixed);
     total_time = total_time + time;
-    total_times.emplace_back(time);
+    total_times[repetition - 1] = time;
+    total_cpu_times[repetition - 1] = cpu_time;
     if(time.count() != 0) time_measurements++;
 
-    absolute_error = results.second - optimal_value;
-    relative_error = (absolute_error / optimal_value);
-    total_absolute_error = total_absolute_error + absolute_error;
-    total_relative_error = total_relative_error + relative_error;
+    if(optimal_value >= 0) {
+        absolute_error = results.second - optimal_value;
+        relative_error = (absolute_error / optimal_value);
+        total_absolute_error = total_absolute_error + absolute_error;
+        total_relative_error = total_relative_error + relative_error;
 
-    cout << "Blad bezwzgledny dla rozwiazania " << repetition << ": " << absolute_error << endl;
-    cout << "Blad wzgledny dla rozwiazania " << repetition << ": " << relative_error << " = " << relative_error * 100 << "% " << endl << endl;
+        cout << "Blad bezwzgledny dla rozwiazania " << repetition << ": " << absolute_error << endl;
+        cout << "Blad wzgledny dla rozwiazania " << repetition << ": " << relative_error << " = " << relative_error * 100 << "% " << endl << endl;
+    }
 
     cout << endl;
 }
@@ -104,23 +219,40 @@ void Main::print_total_results() {
     else if(total_time.count() / time_measurements >= 1000) cout << chrono::duration<double, milli>(total_time).count() / time_measurements << " ms" << endl;
     else cout << total_time.count() / time_measurements << " micro" << endl;
     cout.unsetf(ios::fixed);
+    if(optimal_value < 0) {
+        cout << "Brak wyniku optymalnego - bledy nie zostaly policzone" << endl;
+        return;
+    }
     cout << "Sredni blad bezwzgledny: " << total_absolute_error / repetitions << endl;
     cout << "Sredni blad wzgledny: " << total_relative_error / repetitions << " = " << (total_relative_error / repetitions) * 100 << "% " << endl;
 
 }
 
-int Main::calculate_path_length(vector<int> path) {
-    int path_length = 0;
+Cost Main::calculate_path_length(vector<int> path) {
+    Cost path_length = 0;
 
     for(int i = 0; i < path.size() - 1; i++) {
-        if(matrix[path[i]][path[i + 1]] == -1) return -1;
-        else path_length = path_length + matrix[path[i]][path[i + 1]];
+        if(matrix->at(path[i], path[i + 1]) == -1) return -1;
+        else path_length = path_length + matrix->at(path[i], path[i + 1]);
     }
     return path_length;
 }
 
+chrono::duration<double, micro> Main::thread_cpu_time() {
+#ifdef _WIN32
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time);
+    unsigned long long ticks = (static_cast<unsigned long long>(kernel_time.dwHighDateTime) << 32 | kernel_time.dwLowDateTime) +
+                               (static_cast<unsigned long long>(user_time.dwHighDateTime) << 32 | user_time.dwLowDateTime);
+    return chrono::duration<double, micro>(ticks / 10.0);
+#else
+    timespec cpu_time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time);
+    return chrono::duration<double, micro>(cpu_time.tv_sec * 1e6 + cpu_time.tv_nsec / 1e3);
+#endif
+}
+
 int main() {
-    srand(time(nullptr));
     Main main_obj{};
     main_obj.run();
     cout << endl;
@@ -16,31 +16,57 @@ public:
 
 private:
     string config_path = R"(files/config.txt)";
+    const char* initial_solution_names[7] = {"losowe", "NN", "zachlanne krawedziowe", "najtansze wstawianie", "najdalsze wstawianie",
+                                             "krzywa Hilberta", "przydzial z laczeniem cykli Karpa"};
     string data_path;
     string result_path;
     int minutes;
+    int milliseconds;
+    int max_iterations;
+    Cost target_cost;
+    Budget budget;
+    Search_parameters search_parameters;
+    int trace_capacity;
+    int trace_interval;
+    int matrix_cache;
+    int implicit_distances;
+    int two_level_threshold;
     int solution_generator;
     float restart_factor;
     float end_factor;
     int upper_bound;
-    int optimal_value;
+    Cost optimal_value;
+    long long lower_bound = -1;
     int progress_indicator;
     int repetitions;
     float tenure_factor;
     float list_factor;
+    int threads;
+    int parallel_repetitions;
+    int islands;
+    int exchange_interval;
+    int candidates;
+    int dont_look_bits;
+    int segment_length;
+    int beam_width;
+    uint64_t seed;
     File_manager file_manager;
-    vector<vector<int>> matrix;
-    TSP tsp;
+    shared_ptr<Distance> matrix;
+    vector<TSP> solvers;
+    vector<unique_ptr<Thread_pool>> island_pools;
     chrono::duration<double, micro> total_time{};
     float total_absolute_error;
     float total_relative_error;
     vector<chrono::duration<double, micro>> total_times;
+    vector<chrono::duration<double, micro>> total_cpu_times;
     int time_measurements = 0;
 
-    void assign_parameters(vector<string> parameters_string, vector<int> parameters_int, vector<float> parameters_float);
+    bool assign_parameters(vector<string> parameters_string, vector<int> parameters_int, vector<float> parameters_float);
+    pair<vector<int>, Cost> run_repetition(int worker, int repetition, chrono::duration<double, micro>& cpu_time);
     void print_info();
-    void print_partial_results(pair<vector<int>, int> results, int repetition, chrono::duration<double, micro> time);
-    int calculate_path_length(vector<int> path);
+    void print_partial_results(pair<vector<int>, Cost> results, int repetition, chrono::duration<double, micro> time, chrono::duration<double, micro> cpu_time);
+    static chrono::duration<double, micro> thread_cpu_time();
+    Cost calculate_path_length(vector<int> path);
     void print_total_results();
 
 };
@@ -0,0 +1,55 @@
+#include "Mapped_file.hpp"
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+Mapped_file::Mapped_file(const string& path, bool copy_on_write) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE) return;
+    file_handle = file;
+    opened = true;
+
+    LARGE_INTEGER file_size;
+    GetFileSizeEx(file, &file_size);
+    mapped_size = size_t(file_size.QuadPart);
+    if(mapped_size == 0) return;
+
+    mapping_handle = CreateFileMappingA(file, nullptr, copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+    if(mapping_handle != nullptr) mapped_data = MapViewOfFile(mapping_handle, copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+    if(mapped_data == nullptr) opened = false;
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if(file < 0) return;
+    opened = true;
+
+    struct stat file_status{};
+    fstat(file, &file_status);
+    mapped_size = size_t(file_status.st_size);
+    if(mapped_size > 0) {
+        void* address = mmap(nullptr, mapped_size, copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, file, 0);
+        if(address == MAP_FAILED) opened = false;
+        else {
+            mapped_data = address;
+            madvise(address, mapped_size, MADV_SEQUENTIAL);
+        }
+    }
+    close(file);
+#endif
+}
+
+Mapped_file::~Mapped_file() {
+#ifdef _WIN32
+    if(mapped_data != nullptr) UnmapViewOfFile(mapped_data);
+    if(mapping_handle != nullptr) CloseHandle(mapping_handle);
+    if(file_handle != nullptr) CloseHandle(file_handle);
+#else
+    if(mapped_data != nullptr) munmap(mapped_data, mapped_size);
+#endif
+}
@@ -0,0 +1,31 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+class Mapped_file {
+
+public:
+    explicit Mapped_file(const string& path, bool copy_on_write = false);
+    ~Mapped_file();
+    Mapped_file(const Mapped_file&) = delete;
+    Mapped_file& operator=(const Mapped_file&) = delete;
+
+    bool is_open() const { return opened; }
+    const char* data() const { return static_cast<const char*>(mapped_data); }
+    char* data() { return static_cast<char*>(mapped_data); }
+    size_t size() const { return mapped_size; }
+
+private:
+    void* mapped_data = nullptr;
+    size_t mapped_size = 0;
+    bool opened = false;
+#ifdef _WIN32
+    void* file_handle = nullptr;
+    void* mapping_handle = nullptr;
+#endif
+};
+
+#endif
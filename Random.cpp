@@ -0,0 +1,45 @@
+#include "Random.hpp"
+
+Random::Random(uint64_t seed, uint64_t stream) {
+    this -> seed(seed, stream);
+}
+
+void Random::seed(uint64_t seed, uint64_t stream) {
+    for(uint64_t& word : state) {
+        seed += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        word = z ^ (z >> 31);
+    }
+    for(uint64_t i = 0; i < stream; i++) jump();
+}
+
+uint32_t Random::uniform(uint32_t bound) {
+    uint64_t product = uint64_t(uint32_t((*this)() >> 32)) * bound;
+    uint32_t low = uint32_t(product);
+
+    if(low < bound) {
+        uint32_t threshold = uint32_t(-bound) % bound;
+        while(low < threshold) {
+            product = uint64_t(uint32_t((*this)() >> 32)) * bound;
+            low = uint32_t(product);
+        }
+    }
+    return uint32_t(product >> 32);
+}
+
+void Random::jump() {
+    static const uint64_t jump_polynomial[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+    uint64_t jumped[4] = {0, 0, 0, 0};
+
+    for(uint64_t polynomial : jump_polynomial) {
+        for(int bit = 0; bit < 64; bit++) {
+            if(polynomial & (uint64_t(1) << bit)) {
+                for(int i = 0; i < 4; i++) jumped[i] ^= state[i];
+            }
+            (*this)();
+        }
+    }
+    for(int i = 0; i < 4; i++) state[i] = jumped[i];
+}
@@ -0,0 +1,39 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+#include <cstdint>
+
+using namespace std;
+
+class Random {
+
+public:
+    using result_type = uint64_t;
+
+    explicit Random(uint64_t seed = 0, uint64_t stream = 0);
+    void seed(uint64_t seed, uint64_t stream = 0);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()() {
+        uint64_t result = rotate_left(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotate_left(state[3], 45);
+        return result;
+    }
+
+    uint32_t uniform(uint32_t bound);
+
+private:
+    uint64_t state[4];
+
+    static uint64_t rotate_left(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+    void jump();
+};
+
+#endif
@@ -1,200 +1,971 @@
 #include "TSP.hpp"
+#include <numeric>
 
-void TSP::set_matrix(vector<vector<int>> matrix) {
+void TSP::set_matrix(shared_ptr<const Distance> matrix, int candidates) {
     this -> matrix = std::move(matrix);
+    dense_values = this -> matrix -> values();
+    dense_stride = this -> matrix -> stride();
+    weight_size = this -> matrix -> weight_size();
+    this -> candidates = min(max(candidates, 0), this -> matrix -> size() - 1);
     set_min_value();
+    set_candidate_lists();
+
+    has_forbidden_edges = false;
+    symmetric = true;
+    for(int i = 0; i < this -> matrix -> size() && this -> matrix -> is_dense(); i++) {
+        for(int j = 0; j < this -> matrix -> size(); j++) {
+            if(i != j && this -> matrix -> at(i, j) == -1) has_forbidden_edges = true;
+            if(this -> matrix -> at(i, j) != this -> matrix -> at(j, i)) symmetric = false;
+        }
+    }
+}
+
+void TSP::set_threads(int threads) {
+    if(threads > 1) pool.reset(new Thread_pool(threads));
+    else pool.reset();
+}
+
+void TSP::set_seed(uint64_t seed, uint64_t stream) {
+    generator.seed(seed, stream);
+}
+
+void TSP::set_elite_pool(Elite_pool* elite_pool, int exchange_interval) {
+    this -> elite_pool = elite_pool;
+    this -> exchange_interval = max(1, exchange_interval);
+}
+
+void TSP::set_dont_look_bits(bool dont_look_bits) {
+    this -> dont_look_bits = dont_look_bits;
+}
+
+void TSP::set_segment_length(int segment_length) {
+    max_segment_length = max(1, segment_length);
+}
+
+void TSP::set_beam_width(int beam_width) {
+    this -> beam_width = max(1, beam_width);
+}
+
+void TSP::set_coordinates(vector<pair<double, double>> coordinates) {
+    this -> coordinates = std::move(coordinates);
+}
+
+void TSP::set_assignment(vector<int> assignment_successors) {
+    this -> assignment_successors = std::move(assignment_successors);
+}
+
+void TSP::set_trace(int capacity, int sampling_interval) {
+    trace.set_capacity(capacity, sampling_interval);
+}
+
+void TSP::set_two_level_threshold(int two_level_threshold) {
+    this -> two_level_threshold = two_level_threshold;
 }
 
 void TSP::set_min_value() {
-    for(auto & i : matrix) for(int j : i) if(j < min_value && j >= 0) min_value = j;
+    for(int i = 0; i < matrix->size() && matrix->is_dense(); i++) {
+        for(int j = 0; j < matrix->size(); j++) if(matrix->at(i, j) < min_value && matrix->at(i, j) >= 0) min_value = matrix->at(i, j);
+    }
 }
 
-pair<vector<int>, int> TSP::TS(float end_factor, float restart_factor, int upper_bound, int solution_generator, int minutes, int optimal_value, float tenure_factor, float list_factor) {
-    chrono::time_point<chrono::steady_clock> start = chrono::steady_clock::now();
-    results.second = INT_MAX;
-    pair<vector<int>, int> x0;
-    if(upper_bound == 1) x0 = NN();
-    else x0 = random();
-    results = x0;
-    int current_path_length = results.second;
-    pair<vector<int>, int> xa = x0;
-    deque<pair<vector<int>, int>> tabu_list;
-
-    float surroundings_size = float(generate_surroundings(xa.first, solution_generator).size());
-    int tenure = tenure_factor * surroundings_size;
-    int max_tabu_size = list_factor * surroundings_size;
-    int end_counter = end_factor * surroundings_size;
-    int restart_counter = restart_factor * surroundings_size;
-
-    while(chrono::duration_cast<chrono::minutes>(chrono::steady_clock::now() - start).count() < minutes) {
-        if(results.second == optimal_value) return results;
-        vector<pair<vector<int>, int>> surroundings = generate_surroundings(xa.first, solution_generator);
-        pair<vector<int>, int> best_solution;
-        best_solution.second = INT_MAX;
-
-        for(const auto& solution : surroundings) {
-            if(solution.second < best_solution.second && (!is_in_tabu_list(tabu_list, solution.first) || solution.second < results.second)) {
-                best_solution = solution;
-                best_solution.second = solution.second;
-
-                tabu_list.emplace_back(solution.first, tenure);
-
-                if(tabu_list.size() > max_tabu_size) {
-                    tabu_list.pop_front();
+void TSP::set_candidate_lists() {
+    int size = matrix->size();
+    vector<pair<int, int>> outgoing;
+    vector<pair<int, int>> incoming;
+    outgoing_candidates.assign(size * candidates, -1);
+    incoming_candidates.assign(size * candidates, -1);
+    if(candidates == 0) return;
+
+    if(!matrix->is_dense()) {
+        vector<int> neighbours;
+        for(int i = 0; i < size; i++) {
+            matrix->nearest_neighbours(i, candidates, neighbours);
+            copy(neighbours.begin(), neighbours.end(), outgoing_candidates.begin() + i * candidates);
+            copy(neighbours.begin(), neighbours.end(), incoming_candidates.begin() + i * candidates);
+        }
+        return;
+    }
+
+    for(int i = 0; i < size; i++) {
+        outgoing.clear();
+        incoming.clear();
+        for(int j = 0; j < size; j++) {
+            if(j == i) continue;
+            if(matrix->at(i, j) != -1) outgoing.emplace_back(matrix->at(i, j), j);
+            if(matrix->at(j, i) != -1) incoming.emplace_back(matrix->at(j, i), j);
+        }
+
+        int outgoing_count = min(candidates, int(outgoing.size()));
+        int incoming_count = min(candidates, int(incoming.size()));
+        partial_sort(outgoing.begin(), outgoing.begin() + outgoing_count, outgoing.end());
+        partial_sort(incoming.begin(), incoming.begin() + incoming_count, incoming.end());
+        for(int k = 0; k < outgoing_count; k++) outgoing_candidates[i * candidates + k] = outgoing[k].second;
+        for(int k = 0; k < incoming_count; k++) incoming_candidates[i * candidates + k] = incoming[k].second;
+    }
+}
+
+template<typename Neighbourhood, typename Consumer>
+void TSP::scan_surroundings(const vector<int>& solution, Consumer consume, int first_row, int row_step) {
+    dispatch_weight([&](auto weight) {
+        using Weight = decltype(weight);
+        if(candidates > 0) generate_granular_surroundings<Neighbourhood, Weight>(solution, consume, first_row, row_step);
+        else generate_surroundings<Neighbourhood, Weight>(solution, consume, first_row, row_step);
+    });
+}
+
+template<typename Function>
+void TSP::dispatch_neighbourhood(int solution_generator, Function function) {
+    if(solution_generator == Swap_neighbourhood::type) function(Swap_neighbourhood{});
+    else if(solution_generator == Insertion_neighbourhood::type) function(Insertion_neighbourhood{});
+    else if(solution_generator == Segment_neighbourhood::type) function(Segment_neighbourhood{});
+    else function(Inversion_neighbourhood{});
+}
+
+template<typename Function>
+void TSP::dispatch_weight(Function function) const {
+    if(dense_values == nullptr) function(Implicit_weight{});
+    else if(weight_size == sizeof(uint8_t)) function(uint8_t{});
+    else if(weight_size == sizeof(uint16_t)) function(uint16_t{});
+    else function(int32_t{});
+}
+
+template<typename Weight>
+int TSP::distance(int from, int to) const {
+    if constexpr(is_same<Weight, Implicit_weight>::value) return matrix->at(from, to);
+    else return Distance::decode(static_cast<const Weight*>(dense_values)[size_t(from) * dense_stride + to]);
+}
+
+template<typename Neighbourhood, typename Weight>
+Cost TSP::move_delta(const vector<int>& path, int i, int j) {
+    if constexpr(is_same<Neighbourhood, Swap_neighbourhood>::value) return swap_delta<Weight>(path, i, j);
+    else if constexpr(is_same<Neighbourhood, Insertion_neighbourhood>::value) return insertion_delta<Weight>(path, i, j);
+    else return inversion_delta<Weight>(path, i, j);
+}
+
+template<typename Neighbourhood, typename Weight, typename Consumer>
+void TSP::generate_surroundings(const vector<int>& solution, Consumer consume, int first_row, int row_step) {
+    int size = solution.size() - 1;
+
+    for(int i = first_row; i < size; i += row_step) {
+        if constexpr(is_same<Neighbourhood, Segment_neighbourhood>::value) {
+            for(int segment_length = 1; segment_length <= max_segment_length && i + segment_length < size; segment_length++) {
+                for(int j = 0; j < size; j++) {
+                    if(!is_segment_target(size, i, j, segment_length)) continue;
+                    Cost delta = segment_delta<Weight>(solution, i, j, segment_length);
+                    if(delta != infinite_cost) consume(Move{Neighbourhood::type, i, j, delta, segment_length});
+                }
+            }
+        } else {
+            for(int j = i + 1; j < size; j++) {
+                Cost delta = move_delta<Neighbourhood, Weight>(solution, i, j);
+                if(delta != infinite_cost) consume(Move{Neighbourhood::type, i, j, delta});
+            }
+        }
+    }
+}
+
+template<typename Neighbourhood, typename Weight, typename Consumer>
+void TSP::generate_granular_surroundings(const vector<int>& solution, Consumer consume, int first_row, int row_step) {
+    int size = solution.size() - 1;
+
+    for(int x = first_row; x < size; x += row_step) {
+        if(dont_look_bits && dont_look[solution[x]]) continue;
+        const int* outgoing = &outgoing_candidates[solution[x] * candidates];
+        const int* incoming = &incoming_candidates[solution[x] * candidates];
+        const int* outgoing_previous = &outgoing_candidates[solution[x == 0 ? size - 1 : x - 1] * candidates];
+        const int* incoming_next = &incoming_candidates[solution[x + 1] * candidates];
+        bool improving = false;
+
+        auto emit = [&](int i, int j, Cost delta, int segment_length = 1) {
+            if(delta == infinite_cost) return;
+            if(delta < 0) improving = true;
+            consume(Move{Neighbourhood::type, i, j, delta, segment_length});
+        };
+
+        for(int k = 0; k < candidates; k++) {
+            if constexpr(is_same<Neighbourhood, Swap_neighbourhood>::value) {
+                if(outgoing_previous[k] != -1 && positions[outgoing_previous[k]] != x) {
+                    int y = positions[outgoing_previous[k]];
+                    emit(min(x, y), max(x, y), swap_delta<Weight>(solution, min(x, y), max(x, y)));
+                }
+                if(incoming_next[k] != -1 && positions[incoming_next[k]] != x) {
+                    int y = positions[incoming_next[k]];
+                    emit(min(x, y), max(x, y), swap_delta<Weight>(solution, min(x, y), max(x, y)));
+                }
+            } else if constexpr(is_same<Neighbourhood, Inversion_neighbourhood>::value) {
+                if(outgoing_previous[k] != -1 && positions[outgoing_previous[k]] > x) {
+                    emit(x, positions[outgoing_previous[k]], inversion_delta<Weight>(solution, x, positions[outgoing_previous[k]]));
+                }
+                if(incoming_next[k] != -1 && positions[incoming_next[k]] < x) {
+                    emit(positions[incoming_next[k]], x, inversion_delta<Weight>(solution, positions[incoming_next[k]], x));
+                }
+            } else if constexpr(is_same<Neighbourhood, Insertion_neighbourhood>::value) {
+                if(incoming[k] != -1 && positions[incoming[k]] > x) {
+                    emit(x, positions[incoming[k]], insertion_delta<Weight>(solution, x, positions[incoming[k]]));
+                }
+                if(outgoing[k] != -1 && positions[outgoing[k]] - 1 > x) {
+                    emit(x, positions[outgoing[k]] - 1, insertion_delta<Weight>(solution, x, positions[outgoing[k]] - 1));
+                }
+            } else {
+                for(int segment_length = 1; segment_length <= max_segment_length && x + segment_length < size; segment_length++) {
+                    int last = solution[x + segment_length - 1];
+                    int outgoing_last = outgoing_candidates[last * candidates + k];
+                    if(incoming[k] != -1 && is_segment_target(size, x, positions[incoming[k]], segment_length)) {
+                        emit(x, positions[incoming[k]], segment_delta<Weight>(solution, x, positions[incoming[k]], segment_length), segment_length);
+                    }
+                    if(outgoing_last == -1) continue;
+                    int before = positions[outgoing_last] == 0 ? size - 1 : positions[outgoing_last] - 1;
+                    if(is_segment_target(size, x, before, segment_length)) {
+                        emit(x, before, segment_delta<Weight>(solution, x, before, segment_length), segment_length);
+                    }
                 }
             }
         }
+        if(dont_look_bits && !improving) dont_look[solution[x]] = 1;
+    }
+}
 
-        xa = best_solution;
-        if(best_solution.second < results.second) results = best_solution;
+template<typename Neighbourhood, typename Consumer>
+void TSP::scan_two_level_surroundings(Consumer consume, int first_city, int city_step) {
+    dispatch_weight([&](auto weight) {
+        generate_two_level_surroundings<Neighbourhood, decltype(weight)>(consume, first_city, city_step);
+    });
+}
 
-        update_tabu_list(tabu_list);
+template<typename Neighbourhood, typename Weight, typename Consumer>
+void TSP::generate_two_level_surroundings(Consumer consume, int first_city, int city_step) {
+    int size = tour.size();
+
+    for(int x = first_city; x < size; x += city_step) {
+        if(dont_look_bits && dont_look[x]) continue;
+        const int* outgoing = &outgoing_candidates[x * candidates];
+        const int* incoming = &incoming_candidates[x * candidates];
+        int previous_x = tour.previous(x);
+        bool improving = false;
+
+        auto emit = [&](int i, int j, Cost delta, int segment_length = 1) {
+            if(delta == infinite_cost) return;
+            if(delta < 0) improving = true;
+            consume(Move{Neighbourhood::type, i, j, delta, segment_length});
+        };
+
+        if constexpr(is_same<Neighbourhood, Inversion_neighbourhood>::value) {
+            int next_x = tour.next(x);
+            for(int k = 0; k < candidates && outgoing[k] != -1; k++) {
+                int c = outgoing[k];
+                if(c == next_x || c == previous_x) continue;
+                if(c < x && !dont_look_bits && find(&outgoing_candidates[c * candidates], &outgoing_candidates[c * candidates] + candidates, x) != &outgoing_candidates[c * candidates] + candidates) continue;
+                int joined_length = distance<Weight>(x, c);
+                int next_c = tour.next(c);
+                int previous_c = tour.previous(c);
+                emit(min(x, c), max(x, c), two_opt_delta<Weight>(x, next_x, c, next_c, joined_length));
+                emit(min(previous_x, previous_c), max(previous_x, previous_c), two_opt_delta<Weight>(x, previous_x, c, previous_c, joined_length));
+            }
+        } else {
+            int last = x;
+            for(int segment_length = 1; segment_length <= max_segment_length && segment_length + 2 < size; segment_length++) {
+                if(segment_length > 1) last = tour.next(last);
+                int next = tour.next(last);
+                int bridge_length = distance<Weight>(previous_x, next);
+                if(bridge_length == -1) continue;
+                Cost removal_delta = Cost(bridge_length) - tour_edge(previous_x, x) - tour_edge(last, next);
+                const int* outgoing_last = &outgoing_candidates[last * candidates];
+                auto is_outside = [&](int target) {
+                    return target != previous_x && target != x && target != last && (segment_length < 3 || !tour.between(x, target, last));
+                };
+                for(int k = 0; k < candidates; k++) {
+                    int target = incoming[k];
+                    if(target != -1 && is_outside(target)) {
+                        emit(x, target, or_opt_delta<Weight>(x, last, target, tour.next(target), removal_delta), segment_length);
+                    }
+                    if(outgoing_last[k] == -1) continue;
+                    target = tour.previous(outgoing_last[k]);
+                    if(is_outside(target)) {
+                        emit(x, target, or_opt_delta<Weight>(x, last, target, outgoing_last[k], removal_delta), segment_length);
+                    }
+                }
+            }
+        }
+        if(dont_look_bits && !improving) dont_look[x] = 1;
+    }
+}
+
+long long TSP::count_surroundings(const vector<int>& solution, int solution_generator) {
+    long long count = 0;
+    dispatch_neighbourhood(solution_generator, [&](auto neighbourhood) {
+        scan_surroundings<decltype(neighbourhood)>(solution, [&](const Move&) { count++; });
+    });
+    return count;
+}
+
+pair<vector<int>, Cost> TSP::TS(const Search_parameters& parameters) {
+    pair<vector<int>, Cost> solution;
+    dispatch_neighbourhood(parameters.solution_generator, [&](auto neighbourhood) {
+        using Neighbourhood = decltype(neighbourhood);
+        if constexpr(is_same<Neighbourhood, Inversion_neighbourhood>::value || is_same<Neighbourhood, Segment_neighbourhood>::value) {
+            if(uses_two_level_list()) {
+                solution = search_two_level<Neighbourhood>(parameters);
+                return;
+            }
+        }
+        solution = search<Neighbourhood>(parameters);
+    });
+    return solution;
+}
+
+template<typename Neighbourhood>
+pair<vector<int>, Cost> TSP::search(const Search_parameters& parameters) {
+    const Budget& budget = parameters.budget;
+    start = chrono::steady_clock::now();
+    last_clock_check = start;
+    next_clock_check = 0;
+    clock_check_interval = 1;
+    results.second = infinite_cost;
+    pair<vector<int>, Cost> x0 = initial_solution(parameters.upper_bound);
+    results = x0;
+    Cost current_path_length = results.second;
+    pair<vector<int>, Cost> xa = x0;
+    int iteration = 0;
+    int workers = pool ? pool->size() : 1;
+    vector<Move> best_moves(workers);
+    trace.clear();
+    if(trace.is_enabled()) record_trace(iteration, xa.second, false);
+
+    set_path_state(xa.first);
+    float surroundings_size = 0;
+    dont_look.assign(matrix->size(), 0);
+    scan_surroundings<Neighbourhood>(xa.first, [&](const Move&) { surroundings_size++; });
+    dont_look.assign(matrix->size(), 0);
+    int tenure = max(1, int(parameters.tenure_factor * matrix->size()));
+    tabu_list.set_capacity(max(1, int(parameters.list_factor * matrix->size())));
+    int end_counter = parameters.end_factor * surroundings_size;
+    int restart_counter = parameters.restart_factor * surroundings_size;
+
+    function<void(int)> scan = [&](int worker) {
+        Move& best_move = best_moves[worker];
+        best_move = Move{Neighbourhood::type, -1, -1, infinite_cost};
+
+        auto consider = [&](const Move& move) {
+            if(is_better_move(move, best_move) && (!tabu_list.is_tabu(xa.first[move.i], xa.first[move.j], iteration) || xa.second + move.delta < results.second)) {
+                best_move = move;
+            }
+        };
+        scan_surroundings<Neighbourhood>(xa.first, consider, worker, workers);
+    };
+
+    while(!is_budget_exhausted(budget, iteration)) {
+        if(results.second <= budget.target_cost) return results;
+        if(elite_pool && iteration % exchange_interval == 0) {
+            elite_pool->publish(results.first, results.second);
+            if(elite_pool->best_length() <= budget.target_cost) return results;
+        }
+        if(pool) pool->run(scan);
+        else scan(0);
+
+        Move best_move = best_moves[0];
+        for(int k = 1; k < workers; k++) if(is_better_move(best_moves[k], best_move)) best_move = best_moves[k];
+
+        if(best_move.i == -1 && dont_look_bits) dont_look.assign(matrix->size(), 0);
+        if(best_move.i != -1) {
+            if(dont_look_bits) reset_dont_look_bits(xa.first, best_move);
+            tabu_list.insert(xa.first[best_move.i], xa.first[best_move.j], iteration + tenure);
+            apply_move(xa.first, best_move);
+            xa.second = xa.second + best_move.delta;
+            set_path_state(xa.first);
+        }
+        bool improved = xa.second < results.second;
+        if(improved) results = xa;
+        if(trace.is_enabled() && (improved || trace.is_sample_due(iteration))) record_trace(iteration, xa.second, false);
+        iteration++;
 
         if(current_path_length == results.second) {
             end_counter--;
             restart_counter--;
         } else {
             current_path_length = results.second;
-            end_counter = end_factor * surroundings_size;
-            restart_counter = restart_factor * surroundings_size;
+            end_counter = parameters.end_factor * surroundings_size;
+            restart_counter = parameters.restart_factor * surroundings_size;
         }
 
         if(restart_counter < 0) {
-            restart_counter = restart_factor * surroundings_size;
-            xa = random();
+            restart_counter = parameters.restart_factor * surroundings_size;
+            xa = elite_pool ? perturb_elite() : random();
+            if(trace.is_enabled()) record_trace(iteration, xa.second, true);
+            set_path_state(xa.first);
             tabu_list.clear();
+            dont_look.assign(matrix->size(), 0);
         }
         if(end_counter < 0) return results;
     }
     return results;
 }
 
-void TSP::update_tabu_list(deque<pair<vector<int>, int>>& tabu_list) {
-    for(auto& element : tabu_list) element.second--;
-    while(!tabu_list.empty() && tabu_list.front().second <= 0) tabu_list.pop_front();
+bool TSP::uses_two_level_list() const {
+    return two_level_threshold > 0 && matrix->size() >= max(two_level_threshold, 8) && candidates > 0 && symmetric;
+}
+
+template<typename Neighbourhood>
+pair<vector<int>, Cost> TSP::search_two_level(const Search_parameters& parameters) {
+    const Budget& budget = parameters.budget;
+    start = chrono::steady_clock::now();
+    last_clock_check = start;
+    next_clock_check = 0;
+    clock_check_interval = 1;
+    results.second = infinite_cost;
+    results = initial_solution(parameters.upper_bound);
+    Cost current_path_length = results.second;
+    Cost current_cost = results.second;
+    bool best_is_current = false;
+    int iteration = 0;
+    int workers = pool ? pool->size() : 1;
+    vector<Move> best_moves(workers);
+    trace.clear();
+    if(trace.is_enabled()) record_trace(iteration, current_cost, false);
+
+    set_two_level_tour(results.first);
+    float surroundings_size = 0;
+    dont_look.assign(matrix->size(), 0);
+    scan_two_level_surroundings<Neighbourhood>([&](const Move&) { surroundings_size++; });
+    dont_look.assign(matrix->size(), 0);
+    int tenure = max(1, int(parameters.tenure_factor * matrix->size()));
+    tabu_list.set_capacity(max(1, int(parameters.list_factor * matrix->size())));
+    int end_counter = parameters.end_factor * surroundings_size;
+    int restart_counter = parameters.restart_factor * surroundings_size;
+
+    auto store_best = [&]() {
+        if(best_is_current) results.first = tour.sequence(results.first.front());
+        best_is_current = false;
+    };
+
+    function<void(int)> scan = [&](int worker) {
+        Move& best_move = best_moves[worker];
+        best_move = Move{Neighbourhood::type, -1, -1, infinite_cost};
+
+        auto consider = [&](const Move& move) {
+            if(is_better_move(move, best_move) && (!tabu_list.is_tabu(move.i, move.j, iteration) || current_cost + move.delta < results.second)) {
+                best_move = move;
+            }
+        };
+        scan_two_level_surroundings<Neighbourhood>(consider, worker, workers);
+    };
+
+    while(!is_budget_exhausted(budget, iteration)) {
+        if(results.second <= budget.target_cost) break;
+        if(elite_pool && iteration % exchange_interval == 0) {
+            store_best();
+            elite_pool->publish(results.first, results.second);
+            if(elite_pool->best_length() <= budget.target_cost) break;
+        }
+        if(pool) pool->run(scan);
+        else scan(0);
+
+        Move best_move = best_moves[0];
+        for(int k = 1; k < workers; k++) if(is_better_move(best_moves[k], best_move)) best_move = best_moves[k];
+
+        if(best_move.i == -1 && dont_look_bits) dont_look.assign(matrix->size(), 0);
+        if(best_move.i != -1) {
+            if(best_move.delta >= 0) store_best();
+            if(dont_look_bits) reset_two_level_dont_look_bits(best_move);
+            tabu_list.insert(best_move.i, best_move.j, iteration + tenure);
+            apply_two_level_move(best_move);
+            current_cost = current_cost + best_move.delta;
+        }
+        bool improved = current_cost < results.second;
+        if(improved) {
+            results.second = current_cost;
+            best_is_current = true;
+        }
+        if(trace.is_enabled() && (improved || trace.is_sample_due(iteration))) record_trace(iteration, current_cost, false);
+        iteration++;
+
+        if(current_path_length == results.second) {
+            end_counter--;
+            restart_counter--;
+        } else {
+            current_path_length = results.second;
+            end_counter = parameters.end_factor * surroundings_size;
+            restart_counter = parameters.restart_factor * surroundings_size;
+        }
+
+        if(restart_counter < 0) {
+            restart_counter = parameters.restart_factor * surroundings_size;
+            store_best();
+            pair<vector<int>, Cost> xa = elite_pool ? perturb_elite() : random();
+            current_cost = xa.second;
+            set_two_level_tour(xa.first);
+            if(trace.is_enabled()) record_trace(iteration, current_cost, true);
+            tabu_list.clear();
+            dont_look.assign(matrix->size(), 0);
+        }
+        if(end_counter < 0) break;
+    }
+    store_best();
+    return results;
+}
+
+void TSP::record_trace(int iteration, Cost current_cost, bool restart) {
+    int64_t elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    trace.record(iteration, elapsed, current_cost, results.second, restart);
 }
 
-bool TSP::is_in_tabu_list(const deque<pair<vector<int>, int>>& tabu_list, const vector<int>& solution) {
-    for(const auto& tabu : tabu_list) if(tabu.first == solution) return true;
+bool TSP::is_budget_exhausted(const Budget& budget, long long iteration) {
+    if(budget.iterations >= 0 && iteration >= budget.iterations) return true;
+    if(budget.milliseconds < 0 || iteration < next_clock_check) return false;
+
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    chrono::duration<double, milli> since_last_check = now - last_clock_check;
+    chrono::duration<double, milli> remaining = chrono::milliseconds(budget.milliseconds) - (now - start);
+    if(remaining.count() <= 0) return true;
+
+    double target = min(1.0, remaining.count() / 4);
+    if(since_last_check.count() < target / 2 && clock_check_interval < (1 << 16)) clock_check_interval *= 2;
+    else if(since_last_check.count() > target && clock_check_interval > 1) clock_check_interval /= 2;
+    last_clock_check = now;
+    next_clock_check = iteration + clock_check_interval;
     return false;
 }
 
-vector<pair<vector<int>, int>> TSP::generate_surroundings(vector<int> solution, int solution_generator) {
-    vector<pair<vector<int>, int>> surroundings;
-    solution.pop_back();
-    int size = solution.size();
+void TSP::reset_dont_look_bits(const vector<int>& path, const Move& move) {
+    int size = path.size() - 1;
 
-    for(int i = 0; i < size; i++) {
-        for(int j = i + 1; j < size; j++) {
-            vector<int> new_solution = solution;
-            if(solution_generator == 1) swap(new_solution[i], new_solution[j]);
-            else if(solution_generator == 2) reverse(new_solution.begin() + i, new_solution.begin() + j + 1);
-            else if(solution_generator == 3) {
-                int value_to_insert = new_solution[i];
-                new_solution.erase(new_solution.begin() + i);
-                new_solution.insert(new_solution.begin() + j, value_to_insert);
-            }
-            new_solution.push_back(new_solution.front());
-            int new_solution_length = calculate_path_length(new_solution);
-            if(new_solution_length != INT_MAX) surroundings.emplace_back(new_solution, new_solution_length);
-        }
+    for(int position : {move.i, move.j, move.i + move.segment_length - 1}) {
+        dont_look[path[position == 0 ? size - 1 : position - 1]] = 0;
+        dont_look[path[position]] = 0;
+        dont_look[path[position + 1]] = 0;
     }
-    return surroundings;
 }
 
-pair<vector<int>, int> TSP::random() {
-    pair<vector<int>, int> randomResults;
-    vector<int> path;
-    random_device random;
-    mt19937 g(static_cast<unsigned>(chrono::system_clock::now().time_since_epoch().count()));
-    randomResults.second = INT_MAX;
+bool TSP::is_better_move(const Move& move, const Move& best_move) {
+    if(move.delta != best_move.delta) return move.delta < best_move.delta;
+    return make_tuple(move.i, move.segment_length, move.j) < make_tuple(best_move.i, best_move.segment_length, best_move.j);
+}
+
+int TSP::segment_end(int first, int segment_length) const {
+    int last = first;
+    for(int k = 1; k < segment_length; k++) last = tour.next(last);
+    return last;
+}
+
+void TSP::reset_two_level_dont_look_bits(const Move& move) {
+    if(move.type == Inversion_neighbourhood::type) {
+        for(int city : {move.i, tour.next(move.i), move.j, tour.next(move.j)}) dont_look[city] = 0;
+        return;
+    }
+    int last = segment_end(move.i, move.segment_length);
+    for(int city : {tour.previous(move.i), move.i, last, tour.next(last), move.j, tour.next(move.j)}) dont_look[city] = 0;
+}
+
+void TSP::apply_two_level_move(const Move& move) {
+    if(move.type == Inversion_neighbourhood::type) {
+        int next_i = tour.next(move.i);
+        int next_j = tour.next(move.j);
+        replace_tour_edge(move.i, next_i, move.j);
+        replace_tour_edge(move.j, next_j, move.i);
+        replace_tour_edge(next_i, move.i, next_j);
+        replace_tour_edge(next_j, move.j, next_i);
+        tour.reverse(next_i, move.j);
+        return;
+    }
+    int previous = tour.previous(move.i);
+    int last = segment_end(move.i, move.segment_length);
+    int next = tour.next(last);
+    int after_target = tour.next(move.j);
+    replace_tour_edge(previous, move.i, next);
+    replace_tour_edge(next, last, previous);
+    replace_tour_edge(move.i, previous, move.j);
+    replace_tour_edge(move.j, after_target, move.i);
+    replace_tour_edge(last, next, after_target);
+    replace_tour_edge(after_target, move.j, last);
+    tour.reverse(move.i, move.j);
+    tour.reverse(move.j, next);
+    tour.reverse(last, move.i);
+}
+
+void TSP::set_two_level_tour(const vector<int>& path) {
+    int size = path.size() - 1;
+    tour.set_tour(path);
+    tour_edge_cities.resize(2 * size);
+    tour_edge_lengths.resize(2 * size);
+
+    for(int k = 0; k < size; k++) {
+        int city = path[k];
+        int previous = path[k == 0 ? size - 1 : k - 1];
+        tour_edge_cities[2 * city] = previous;
+        tour_edge_lengths[2 * city] = matrix->at(city, previous);
+        tour_edge_cities[2 * city + 1] = path[k + 1];
+        tour_edge_lengths[2 * city + 1] = matrix->at(city, path[k + 1]);
+    }
+}
+
+int TSP::tour_edge(int a, int b) const {
+    return tour_edge_cities[2 * a] == b ? tour_edge_lengths[2 * a] : tour_edge_lengths[2 * a + 1];
+}
+
+void TSP::replace_tour_edge(int city, int old_neighbour, int new_neighbour) {
+    int slot = tour_edge_cities[2 * city] == old_neighbour ? 2 * city : 2 * city + 1;
+    tour_edge_cities[slot] = new_neighbour;
+    tour_edge_lengths[slot] = matrix->at(city, new_neighbour);
+}
+
+void TSP::apply_move(vector<int>& path, const Move& move) {
+    if(move.type == 1) swap(path[move.i], path[move.j]);
+    else if(move.type == 2) reverse(path.begin() + move.i, path.begin() + move.j + 1);
+    else if(move.type == 3) rotate(path.begin() + move.i, path.begin() + move.i + 1, path.begin() + move.j + 1);
+    else if(move.type == 4 && move.j > move.i) rotate(path.begin() + move.i, path.begin() + move.i + move.segment_length, path.begin() + move.j + 1);
+    else if(move.type == 4) rotate(path.begin() + move.j + 1, path.begin() + move.i, path.begin() + move.i + move.segment_length);
+    path.back() = path.front();
+}
+
+template<typename Weight>
+Cost TSP::edges_delta(initializer_list<pair<int, int>> removed_edges, initializer_list<pair<int, int>> added_edges) {
+    Cost delta = 0;
+
+    for(const auto& edge : added_edges) {
+        int value = distance<Weight>(edge.first, edge.second);
+        if(value == -1) return infinite_cost;
+        delta = delta + value;
+    }
+    for(const auto& edge : removed_edges) delta = delta - distance<Weight>(edge.first, edge.second);
+    return delta;
+}
+
+template<typename Weight>
+Cost TSP::swap_delta(const vector<int>& path, int i, int j) {
+    int size = path.size() - 1;
+    if(size < 3) return 0;
+
+    int a = path[i];
+    int b = path[j];
+    int previous_a = path[i == 0 ? size - 1 : i - 1];
+    int next_a = path[i + 1];
+    int previous_b = path[j - 1];
+    int next_b = path[j + 1];
+
+    if(j == i + 1) return edges_delta<Weight>({{previous_a, a}, {a, b}, {b, next_b}}, {{previous_a, b}, {b, a}, {a, next_b}});
+    if(i == 0 && j == size - 1) return edges_delta<Weight>({{previous_b, b}, {b, a}, {a, next_a}}, {{previous_b, a}, {a, b}, {b, next_a}});
+    return edges_delta<Weight>({{previous_a, a}, {a, next_a}, {previous_b, b}, {b, next_b}},
+                       {{previous_a, b}, {b, next_a}, {previous_b, a}, {a, next_b}});
+}
+
+template<typename Weight>
+Cost TSP::insertion_delta(const vector<int>& path, int i, int j) {
+    int size = path.size() - 1;
+    if(i == 0 && j == size - 1) return 0;
+
+    int value_to_insert = path[i];
+    int previous = path[i == 0 ? size - 1 : i - 1];
+    int next = path[i + 1];
+    int target = path[j];
+    int after_target = path[j + 1];
+
+    return edges_delta<Weight>({{previous, value_to_insert}, {value_to_insert, next}, {target, after_target}},
+                       {{previous, next}, {target, value_to_insert}, {value_to_insert, after_target}});
+}
+
+template<typename Weight>
+Cost TSP::inversion_delta(const vector<int>& path, int i, int j) {
+    int size = path.size() - 1;
+
+    if(i == 0 && j == size - 1) {
+        if(backward_forbidden[size] > 0) return infinite_cost;
+        return backward_lengths[size] - forward_lengths[size];
+    }
+    if(backward_forbidden[j] - backward_forbidden[i] > 0) return infinite_cost;
+
+    int previous = path[i == 0 ? size - 1 : i - 1];
+    int next = path[j + 1];
+    Cost delta = edges_delta<Weight>({{previous, path[i]}, {path[j], next}}, {{previous, path[j]}, {path[i], next}});
+    if(delta == infinite_cost) return infinite_cost;
+    return delta + (backward_lengths[j] - backward_lengths[i]) - (forward_lengths[j] - forward_lengths[i]);
+}
+
+bool TSP::is_segment_target(int size, int i, int j, int segment_length) {
+    if(j < 0 || (j >= i - 1 && j < i + segment_length)) return false;
+    return !(i == 0 && j == size - 1);
+}
+
+template<typename Weight>
+Cost TSP::segment_delta(const vector<int>& path, int i, int j, int segment_length) {
+    int size = path.size() - 1;
+    int previous = path[i == 0 ? size - 1 : i - 1];
+    int first = path[i];
+    int last = path[i + segment_length - 1];
+    int next = path[i + segment_length];
+
+    return edges_delta<Weight>({{previous, first}, {last, next}, {path[j], path[j + 1]}},
+                       {{previous, next}, {path[j], first}, {last, path[j + 1]}});
+}
 
-    for(int i = 0; i < matrix.size(); i++) path.push_back(i);
+template<typename Weight>
+Cost TSP::two_opt_delta(int a, int b, int c, int d, int joined_length) {
+    if(joined_length == -1) return infinite_cost;
+    int other_length = distance<Weight>(b, d);
+    if(other_length == -1) return infinite_cost;
+    return Cost(joined_length) + other_length - tour_edge(a, b) - tour_edge(c, d);
+}
+
+template<typename Weight>
+Cost TSP::or_opt_delta(int first, int last, int target, int after_target, Cost removal_delta) {
+    int head_length = distance<Weight>(target, first);
+    int tail_length = distance<Weight>(last, after_target);
+    if(head_length == -1 || tail_length == -1) return infinite_cost;
+    return removal_delta + head_length + tail_length - tour_edge(target, after_target);
+}
 
-    while(randomResults.second == INT_MAX) {
-        shuffle(path.begin(), path.end(), g);
-        reverse(path.begin() + g() % matrix.size(), path.end());
+void TSP::set_path_state(const vector<int>& path) {
+    int size = path.size() - 1;
+    forward_lengths.assign(size + 1, 0);
+    backward_lengths.assign(size + 1, 0);
+    backward_forbidden.assign(size + 1, 0);
+    positions.resize(matrix->size());
+
+    for(int k = 0; k < size; k++) {
+        positions[path[k]] = k;
+        int backward_edge = matrix->at(path[k + 1], path[k]);
+        forward_lengths[k + 1] = forward_lengths[k] + matrix->at(path[k], path[k + 1]);
+        backward_lengths[k + 1] = backward_lengths[k] + (backward_edge == -1 ? 0 : backward_edge);
+        backward_forbidden[k + 1] = backward_forbidden[k] + (backward_edge == -1 ? 1 : 0);
+    }
+}
+
+pair<vector<int>, Cost> TSP::random() {
+    pair<vector<int>, Cost> randomResults;
+    vector<int> path;
+    int size = matrix->size();
 
+    if(!has_forbidden_edges) {
+        for(int i = 0; i < size; i++) path.push_back(i);
+        for(int i = size - 1; i > 0; i--) swap(path[i], path[generator.uniform(i + 1)]);
         path.push_back(path.front());
+        randomResults.second = calculate_path_length(path);
         randomResults.first = path;
+        return randomResults;
+    }
+
+    for(int attempt = 0; attempt < 8; attempt++) {
+        path = random_feasible_path(16LL * size);
+        if(path.empty()) continue;
+        path.push_back(path.front());
         randomResults.second = calculate_path_length(path);
+        randomResults.first = path;
+        return randomResults;
+    }
+    return double_bridge(!results.first.empty() && results.second != infinite_cost ? results : NN());
+}
+
+vector<int> TSP::random_feasible_path(long long max_steps) {
+    int size = matrix->size();
+    int start = generator.uniform(size);
+    vector<char> visited(size, 0);
+    vector<int> exits(size, 0);
+    vector<int> entries(size, 0);
+    vector<int> path(1, start);
+    vector<int> options;
+    vector<int> level_begin;
+    vector<int> level_next;
 
-        path.pop_back();
+    for(int i = 0; i < size; i++) {
+        for(int j = 0; j < size; j++) {
+            if(i == j || matrix->at(i, j) == -1) continue;
+            exits[i]++;
+            entries[j]++;
+        }
     }
+    visited[start] = 1;
+
+    auto extend = [&](int from, int node, int change) {
+        for(int i = 0; i < size; i++) {
+            if(i != node && matrix->at(i, node) != -1) exits[i] = exits[i] + change;
+            if(i != from && matrix->at(from, i) != -1) entries[i] = entries[i] + change;
+        }
+    };
+    auto open_level = [&]() {
+        int current = path.back();
+        int forced = -1;
+        bool dead_end = entries[start] == 0;
+        level_begin.push_back(options.size());
+        level_next.push_back(options.size());
+
+        for(int node = 0; node < size && !dead_end; node++) {
+            if(visited[node]) continue;
+            if(path.size() == size - 1) dead_end = matrix->at(current, node) == -1 || matrix->at(node, start) == -1;
+            else if(entries[node] == 0 || exits[node] == 0) dead_end = true;
+            else if(entries[node] == 1 && matrix->at(current, node) != -1) {
+                dead_end = forced != -1;
+                forced = node;
+            }
+        }
+        if(dead_end) return;
 
-    return randomResults;
+        for(int node = 0; node < size; node++) {
+            if(visited[node] || matrix->at(current, node) == -1 || (forced != -1 && node != forced)) continue;
+            options.push_back(node);
+        }
+        for(int i = options.size() - 1; i > level_begin.back(); i--) {
+            swap(options[i], options[level_begin.back() + generator.uniform(i - level_begin.back() + 1)]);
+        }
+        stable_sort(options.begin() + level_begin.back(), options.end(), [&](int a, int b) { return exits[a] < exits[b]; });
+    };
+
+    open_level();
+    for(long long step = 0; path.size() < size; step++) {
+        if(step == max_steps || level_next.empty()) return vector<int>();
+        int& next = level_next.back();
+
+        if(next == options.size()) {
+            options.resize(level_begin.back());
+            level_begin.pop_back();
+            level_next.pop_back();
+            int node = path.back();
+            path.pop_back();
+            if(path.empty()) continue;
+            extend(path.back(), node, 1);
+            visited[node] = 0;
+            continue;
+        }
+        int node = options[next++];
+        extend(path.back(), node, -1);
+        visited[node] = 1;
+        path.push_back(node);
+        if(path.size() < size) open_level();
+    }
+    return path;
 }
 
-int TSP::calculate_path_length(vector<int> path) {
-    int path_length = 0;
+pair<vector<int>, Cost> TSP::perturb_elite() {
+    pair<vector<int>, Cost> elite;
+    if(!elite_pool->sample(elite.first, elite.second, generator)) return random();
+    return double_bridge(elite);
+}
+
+pair<vector<int>, Cost> TSP::double_bridge(const pair<vector<int>, Cost>& tour) {
+    int size = tour.first.size() - 1;
+    if(size < 8) return tour;
+
+    for(int attempt = 0; attempt < 10; attempt++) {
+        int cuts[3];
+        for(int& cut : cuts) cut = 1 + generator.uniform(size - 1);
+        sort(cuts, cuts + 3);
+        if(cuts[0] == cuts[1] || cuts[1] == cuts[2]) continue;
+
+        vector<int> path(tour.first.begin(), tour.first.begin() + cuts[0]);
+        path.insert(path.end(), tour.first.begin() + cuts[1], tour.first.begin() + cuts[2]);
+        path.insert(path.end(), tour.first.begin() + cuts[0], tour.first.begin() + cuts[1]);
+        path.insert(path.end(), tour.first.begin() + cuts[2], tour.first.end());
+
+        Cost path_length = calculate_path_length(path);
+        if(path_length != infinite_cost) return {path, path_length};
+    }
+    return tour;
+}
+
+Cost TSP::calculate_path_length(vector<int> path) {
+    Cost path_length = 0;
 
     for(int i = 0; i < path.size() - 1; i++) {
-        if(matrix[path[i]][path[i + 1]] == -1) return INT_MAX;
-        else path_length = path_length + matrix[path[i]][path[i + 1]];
+        if(matrix->at(path[i], path[i + 1]) == -1) return infinite_cost;
+        else path_length = path_length + matrix->at(path[i], path[i + 1]);
     }
     return path_length;
 }
 
-pair<vector<int>, int> TSP::NN() {
-    pair<vector<int>, int> resultsNN;
-    resultsNN.second = INT_MAX;
-    vector<int> path;
-    vector<int> Q;
-
-    for(int j = 0; j < matrix.size(); j++) {
+pair<vector<int>, Cost> TSP::initial_solution(int upper_bound) {
+    pair<vector<int>, Cost> x0(vector<int>(), infinite_cost);
 
-        path.push_back(j);
+    if(upper_bound == 1) x0 = NN();
+    else if(upper_bound == 2) x0 = Construction::greedy_edge(*matrix);
+    else if(upper_bound == 3) x0 = Construction::cheapest_insertion(*matrix);
+    else if(upper_bound == 4) x0 = Construction::farthest_insertion(*matrix);
+    else if(upper_bound == 5) x0 = Construction::space_filling_curve(*matrix, coordinates);
+    else if(upper_bound == 6 && !assignment_successors.empty()) x0 = Assignment::patch(*matrix, assignment_successors);
+    if(x0.second == infinite_cost) x0 = random();
+    return x0;
+}
 
-        for(int i = 0; i < matrix.size(); i++) if(i != j) Q.push_back(i);
-        explore_paths(path, 0, Q, j, j, resultsNN);
+pair<vector<int>, Cost> TSP::NN() {
+    int workers = pool ? pool->size() : 1;
+    vector<pair<vector<int>, Cost>> worker_results(workers, make_pair(vector<int>(), infinite_cost));
 
-        path.clear();
-        Q.clear();
+    function<void(int)> search = [&](int worker) {
+        for(int start_node = worker; start_node < matrix->size(); start_node += workers) {
+            pair<vector<int>, Cost> resultsNN = nearest_neighbour(start_node);
+            if(resultsNN.second < worker_results[worker].second) worker_results[worker] = resultsNN;
+        }
+    };
+    if(pool) pool->run(search);
+    else search(0);
+
+    pair<vector<int>, Cost> resultsNN = worker_results[0];
+    for(int k = 1; k < workers; k++) {
+        if(worker_results[k].second < resultsNN.second || (worker_results[k].second == resultsNN.second && worker_results[k].first < resultsNN.first)) {
+            resultsNN = worker_results[k];
+        }
     }
     return resultsNN;
 }
 
-void TSP::explore_paths(vector<int> path, int path_length, vector<int> Q, int current_node, int start_node,
-                        pair<vector<int>, int> &resultsNN) {
-    vector<pair<int, int>> min_edges;
-    int min_edge_value = INT_MAX;
-    vector<int> new_path;
-    vector<int> new_Q;
-    int next_node;
-    int edge_length;
-
-    if(Q.empty()) {
-        if(matrix[current_node][start_node] != -1) {
-            path_length += matrix[current_node][start_node];
-            path.push_back(start_node);
+pair<vector<int>, Cost> TSP::nearest_neighbour(int start_node) {
+    int size = matrix->size();
+    int words = (size + 63) / 64;
+    pair<vector<int>, Cost> resultsNN(vector<int>(), infinite_cost);
+    vector<Nearest_state> states(1);
+    vector<Nearest_state> next_states;
+    vector<int> min_nodes;
+
+    states[0].path.push_back(start_node);
+    states[0].visited.assign(words, 0);
+    states[0].visited[start_node / 64] |= uint64_t(1) << (start_node % 64);
+
+    for(int step = 1; step < size && !states.empty(); step++) {
+        next_states.clear();
+
+        for(const auto& state : states) {
+            int from = state.path.back();
+            int min_edge_value = INT_MAX;
+            min_nodes.clear();
+
+            for(int word = 0; word < words; word++) {
+                uint64_t unvisited = ~state.visited[word];
+                if(word == words - 1 && size % 64 != 0) unvisited &= (uint64_t(1) << (size % 64)) - 1;
+                while(unvisited) {
+                    int i = word * 64 + __builtin_ctzll(unvisited);
+                    unvisited &= unvisited - 1;
+                    int edge = matrix->at(from, i);
+                    if(edge == -1 || edge > min_edge_value) continue;
+                    if(edge < min_edge_value) {
+                        min_edge_value = edge;
+                        min_nodes.clear();
+                    }
+                    if(min_nodes.size() < beam_width) min_nodes.push_back(i);
+                }
+            }
 
-            if(path_length < resultsNN.second) {
-                resultsNN.first = path;
-                resultsNN.second = path_length;
+            for(int next_node : min_nodes) {
+                next_states.push_back(state);
+                Nearest_state& next_state = next_states.back();
+                next_state.path.push_back(next_node);
+                next_state.length = state.length + min_edge_value;
+                next_state.visited[next_node / 64] |= uint64_t(1) << (next_node % 64);
             }
         }
-        return;
-    }
 
-    for(int i = 0; i < matrix.size(); i++) {
-        if(matrix[current_node][i] != -1 && find(Q.begin(), Q.end(), i) != Q.end()) {
-            if(matrix[current_node][i] < min_edge_value) {
-                min_edges.clear();
-                min_edge_value = matrix[current_node][i];
-                min_edges.emplace_back(i, matrix[current_node][i]);
-            } else if(matrix[current_node][i] == min_edge_value) min_edges.emplace_back(i, matrix[current_node][i]);
+        if(next_states.size() > beam_width) {
+            stable_sort(next_states.begin(), next_states.end(), [](const Nearest_state& a, const Nearest_state& b) {
+                return a.length < b.length;
+            });
+            next_states.resize(beam_width);
         }
+        swap(states, next_states);
     }
 
-    for(auto & min_edge : min_edges) {
-        next_node = min_edge.first;
-        edge_length = min_edge.second;
-
-        new_path = path;
-        new_path.push_back(next_node);
-        new_Q = Q;
-        new_Q.erase(remove(new_Q.begin(), new_Q.end(), next_node), new_Q.end());
-
-        explore_paths(new_path, path_length + edge_length, new_Q, next_node, start_node, resultsNN);
+    for(auto& state : states) {
+        if(state.path.size() != size || matrix->at(state.path.back(), start_node) == -1) continue;
+        Cost path_length = state.length + matrix->at(state.path.back(), start_node);
+        if(path_length < resultsNN.second) {
+            state.path.push_back(start_node);
+            resultsNN.first = state.path;
+            resultsNN.second = path_length;
+        }
     }
-}
\ No newline at end of file
+    return resultsNN;
+}
@@ -1,5 +1,14 @@
 #ifndef TSP_HPP
 #define TSP_HPP
+#include "Distance_matrix.hpp"
+#include "Thread_pool.hpp"
+#include "Elite_pool.hpp"
+#include "Construction.hpp"
+#include "Assignment.hpp"
+#include "Random.hpp"
+#include "Convergence_trace.hpp"
+#include "Tabu_list.hpp"
+#include "Two_level_list.hpp"
 #include <vector>
 #include <chrono>
 #include <climits>
@@ -15,28 +24,146 @@
 #include <random>
 #include <map>
 #include <deque>
+#include <memory>
+#include <cstdint>
 
 using namespace std;
 
+struct Nearest_state {
+    vector<int> path;
+    vector<uint64_t> visited;
+    Cost length = 0;
+};
+
+struct Implicit_weight {};
+
+struct Move {
+    int type;
+    int i;
+    int j;
+    Cost delta;
+    int segment_length = 1;
+};
+
+struct Budget {
+    long long milliseconds = -1;
+    long long iterations = -1;
+    Cost target_cost = -1;
+};
+
+struct Search_parameters {
+    float end_factor = 0;
+    float restart_factor = 0;
+    float tenure_factor = 0;
+    float list_factor = 0;
+    int upper_bound = 0;
+    int solution_generator = 2;
+    Budget budget;
+};
+
+struct Swap_neighbourhood { static constexpr int type = 1; };
+struct Inversion_neighbourhood { static constexpr int type = 2; };
+struct Insertion_neighbourhood { static constexpr int type = 3; };
+struct Segment_neighbourhood { static constexpr int type = 4; };
+
 class TSP {
+    friend class Benchmark;
 
 public:
-    void set_matrix(vector<vector<int>> matrix);
-    pair<vector<int>, int> NN();
-    void explore_paths(vector<int> path, int path_length, vector<int> Q, int current_node, int start_node, pair<vector<int>, int> &resultsNN);
-    pair<vector<int>, int> TS(float end_factor, float restart_factor, int upper_bound, int solution_generator, int minutes, int optimal_value, float tenure_factor, float list_factor);
+    void set_matrix(shared_ptr<const Distance> matrix, int candidates = 0);
+    void set_threads(int threads);
+    void set_seed(uint64_t seed, uint64_t stream);
+    void set_elite_pool(Elite_pool* elite_pool, int exchange_interval);
+    void set_dont_look_bits(bool dont_look_bits);
+    void set_segment_length(int segment_length);
+    void set_beam_width(int beam_width);
+    void set_coordinates(vector<pair<double, double>> coordinates);
+    void set_assignment(vector<int> assignment_successors);
+    void set_trace(int capacity, int sampling_interval);
+    void set_two_level_threshold(int two_level_threshold);
+    const Convergence_trace& get_trace() const { return trace; }
+    pair<vector<int>, Cost> NN();
+    pair<vector<int>, Cost> TS(const Search_parameters& parameters);
+    bool uses_two_level_list() const;
 
 private:
-    vector<vector<int>> matrix;
-    pair<vector<int>, int> results;
+    shared_ptr<const Distance> matrix;
+    const void* dense_values = nullptr;
+    int dense_stride = 0;
+    int weight_size = 0;
+    unique_ptr<Thread_pool> pool;
+    Random generator;
+    Elite_pool* elite_pool = nullptr;
+    int exchange_interval = 1;
+    chrono::steady_clock::time_point start;
+    chrono::steady_clock::time_point last_clock_check;
+    long long next_clock_check = 0;
+    long long clock_check_interval = 1;
+    pair<vector<int>, Cost> results;
+    Convergence_trace trace;
     int min_value = INT_MAX;
+    bool has_forbidden_edges = false;
+    bool symmetric = true;
+    vector<long long> forward_lengths;
+    vector<long long> backward_lengths;
+    vector<int> backward_forbidden;
+    vector<int> positions;
+    int candidates = 0;
+    vector<int> outgoing_candidates;
+    vector<int> incoming_candidates;
+    bool dont_look_bits = false;
+    int max_segment_length = 3;
+    int beam_width = 1;
+    vector<pair<double, double>> coordinates;
+    vector<int> assignment_successors;
+    vector<char> dont_look;
+    Tabu_list tabu_list;
+    Two_level_list tour;
+    vector<int> tour_edge_cities;
+    vector<int> tour_edge_lengths;
+    int two_level_threshold = 0;
 
     void set_min_value();
-    pair<vector<int>, int> random();
-    int calculate_path_length(vector<int> path);
-    vector<pair<vector<int>, int>> generate_surroundings(vector<int> solution, int solution_generator);
-    static bool is_in_tabu_list(const deque<pair<vector<int>, int>>& tabu_list, const vector<int>& solution);
-    static void update_tabu_list(deque<pair<vector<int>, int>>& tabu_list);
+    void set_candidate_lists();
+    pair<vector<int>, Cost> initial_solution(int upper_bound);
+    pair<vector<int>, Cost> nearest_neighbour(int start_node);
+    pair<vector<int>, Cost> random();
+    pair<vector<int>, Cost> perturb_elite();
+    pair<vector<int>, Cost> double_bridge(const pair<vector<int>, Cost>& tour);
+    vector<int> random_feasible_path(long long max_steps);
+    Cost calculate_path_length(vector<int> path);
+    template<typename Weight> int distance(int from, int to) const;
+    template<typename Function> void dispatch_weight(Function function) const;
+    template<typename Weight> Cost edges_delta(initializer_list<pair<int, int>> removed_edges, initializer_list<pair<int, int>> added_edges);
+    template<typename Weight> Cost swap_delta(const vector<int>& path, int i, int j);
+    template<typename Weight> Cost insertion_delta(const vector<int>& path, int i, int j);
+    template<typename Weight> Cost inversion_delta(const vector<int>& path, int i, int j);
+    template<typename Weight> Cost segment_delta(const vector<int>& path, int i, int j, int segment_length);
+    static bool is_segment_target(int size, int i, int j, int segment_length);
+    void set_path_state(const vector<int>& path);
+    long long count_surroundings(const vector<int>& solution, int solution_generator);
+    template<typename Neighbourhood> pair<vector<int>, Cost> search(const Search_parameters& parameters);
+    template<typename Function> static void dispatch_neighbourhood(int solution_generator, Function function);
+    template<typename Neighbourhood, typename Weight> Cost move_delta(const vector<int>& path, int i, int j);
+    template<typename Neighbourhood, typename Consumer> void scan_surroundings(const vector<int>& solution, Consumer consume, int first_row = 0, int row_step = 1);
+    template<typename Neighbourhood, typename Weight, typename Consumer> void generate_surroundings(const vector<int>& solution, Consumer consume, int first_row = 0, int row_step = 1);
+    template<typename Neighbourhood, typename Weight, typename Consumer> void generate_granular_surroundings(const vector<int>& solution, Consumer consume, int first_row = 0, int row_step = 1);
+    template<typename Neighbourhood> pair<vector<int>, Cost> search_two_level(const Search_parameters& parameters);
+    template<typename Neighbourhood, typename Consumer> void scan_two_level_surroundings(Consumer consume, int first_city = 0, int city_step = 1);
+    template<typename Neighbourhood, typename Weight, typename Consumer> void generate_two_level_surroundings(Consumer consume, int first_city = 0, int city_step = 1);
+    template<typename Weight> Cost two_opt_delta(int a, int b, int c, int d, int joined_length);
+    template<typename Weight> Cost or_opt_delta(int first, int last, int target, int after_target, Cost removal_delta);
+    int segment_end(int first, int segment_length) const;
+    void set_two_level_tour(const vector<int>& path);
+    int tour_edge(int a, int b) const;
+    void replace_tour_edge(int city, int old_neighbour, int new_neighbour);
+    void reset_two_level_dont_look_bits(const Move& move);
+    void apply_two_level_move(const Move& move);
+    void reset_dont_look_bits(const vector<int>& path, const Move& move);
+    static bool is_better_move(const Move& move, const Move& best_move);
+    static void apply_move(vector<int>& path, const Move& move);
+    bool is_budget_exhausted(const Budget& budget, long long iteration);
+    void record_trace(int iteration, Cost current_cost, bool restart);
 };
 
 #endif
\ No newline at end of file
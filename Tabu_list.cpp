@@ -0,0 +1,66 @@
+#include "Tabu_list.hpp"
+#include <algorithm>
+
+void Tabu_list::set_capacity(int capacity) {
+    size_t table_size = 4;
+    while(table_size < 2 * size_t(max(capacity, 1))) table_size *= 2;
+    order.assign(max(capacity, 1), Entry{empty, 0});
+    slots.assign(table_size, Entry{empty, 0});
+    mask = table_size - 1;
+    head = 0;
+    count = 0;
+}
+
+void Tabu_list::clear() {
+    fill(slots.begin(), slots.end(), Entry{empty, 0});
+    head = 0;
+    count = 0;
+}
+
+void Tabu_list::insert(int a, int b, int expires_at) {
+    uint64_t key = edge_key(a, b);
+
+    if(count == order.size()) {
+        const Entry& oldest = order[head];
+        size_t index = find(oldest.key);
+        if(slots[index].key == oldest.key && slots[index].expires_at == oldest.expires_at) erase(index);
+        head = (head + 1) % order.size();
+        count--;
+    }
+    order[(head + count) % order.size()] = Entry{key, expires_at};
+    count++;
+    slots[find(key)] = Entry{key, expires_at};
+}
+
+bool Tabu_list::is_tabu(int a, int b, int iteration) const {
+    if(count == 0) return false;
+    const Entry& slot = slots[find(edge_key(a, b))];
+    return slot.key != empty && slot.expires_at > iteration;
+}
+
+uint64_t Tabu_list::edge_key(int a, int b) {
+    if(a > b) swap(a, b);
+    return (uint64_t(uint32_t(a)) << 32) | uint32_t(b);
+}
+
+size_t Tabu_list::home(uint64_t key) const {
+    return size_t((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+size_t Tabu_list::find(uint64_t key) const {
+    size_t index = home(key);
+    while(slots[index].key != empty && slots[index].key != key) index = (index + 1) & mask;
+    return index;
+}
+
+void Tabu_list::erase(size_t index) {
+    size_t hole = index;
+
+    for(size_t next = (hole + 1) & mask; slots[next].key != empty; next = (next + 1) & mask) {
+        if(((next - home(slots[next].key)) & mask) >= ((next - hole) & mask)) {
+            slots[hole] = slots[next];
+            hole = next;
+        }
+    }
+    slots[hole].key = empty;
+}
@@ -0,0 +1,36 @@
+#ifndef TABU_LIST_HPP
+#define TABU_LIST_HPP
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+class Tabu_list {
+
+public:
+    void set_capacity(int capacity);
+    void clear();
+    void insert(int a, int b, int expires_at);
+    bool is_tabu(int a, int b, int iteration) const;
+    int size() const { return count; }
+
+private:
+    struct Entry {
+        uint64_t key;
+        int expires_at;
+    };
+
+    static constexpr uint64_t empty = UINT64_MAX;
+    vector<Entry> order;
+    vector<Entry> slots;
+    size_t mask = 0;
+    int head = 0;
+    int count = 0;
+
+    static uint64_t edge_key(int a, int b);
+    size_t home(uint64_t key) const;
+    size_t find(uint64_t key) const;
+    void erase(size_t index);
+};
+
+#endif
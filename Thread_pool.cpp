@@ -0,0 +1,53 @@
+#include "Thread_pool.hpp"
+
+Thread_pool::Thread_pool(int threads) {
+    for(int i = 1; i < threads; i++) workers.emplace_back(&Thread_pool::work, this, i);
+}
+
+Thread_pool::~Thread_pool() {
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        stopping = true;
+    }
+    task_ready.notify_all();
+    for(auto& worker : workers) worker.join();
+}
+
+void Thread_pool::run(const function<void(int)>& task) {
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        current_task = &task;
+        pending = workers.size();
+        generation++;
+    }
+    task_ready.notify_all();
+
+    task(0);
+
+    unique_lock<mutex> lock(pool_mutex);
+    task_done.wait(lock, [this] { return pending == 0; });
+    current_task = nullptr;
+}
+
+void Thread_pool::work(int worker) {
+    long long seen_generation = 0;
+
+    while(true) {
+        const function<void(int)>* task;
+        {
+            unique_lock<mutex> lock(pool_mutex);
+            task_ready.wait(lock, [&] { return stopping || generation != seen_generation; });
+            if(stopping) return;
+            seen_generation = generation;
+            task = current_task;
+        }
+
+        (*task)(worker);
+
+        {
+            lock_guard<mutex> lock(pool_mutex);
+            pending--;
+        }
+        task_done.notify_one();
+    }
+}
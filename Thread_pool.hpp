@@ -0,0 +1,35 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+class Thread_pool {
+
+public:
+    explicit Thread_pool(int threads);
+    ~Thread_pool();
+    Thread_pool(const Thread_pool&) = delete;
+    Thread_pool& operator=(const Thread_pool&) = delete;
+
+    int size() const { return int(workers.size()) + 1; }
+    void run(const function<void(int)>& task);
+
+private:
+    vector<thread> workers;
+    mutex pool_mutex;
+    condition_variable task_ready;
+    condition_variable task_done;
+    const function<void(int)>* current_task = nullptr;
+    long long generation = 0;
+    int pending = 0;
+    bool stopping = false;
+
+    void work(int worker);
+};
+
+#endif
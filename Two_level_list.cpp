@@ -0,0 +1,143 @@
+#include "Two_level_list.hpp"
+#include <algorithm>
+#include <cmath>
+
+void Two_level_list::set_tour(const vector<int>& path) {
+    reversed = false;
+    rebuild(vector<int>(path.begin(), path.end() - 1));
+}
+
+void Two_level_list::reverse(int from, int to) {
+    if(reversed) raw_reverse(to, from);
+    else raw_reverse(from, to);
+}
+
+vector<int> Two_level_list::sequence(int start) const {
+    vector<int> path;
+    path.reserve(size() + 1);
+
+    for(int city = start, k = 0; k < size(); k++, city = next(city)) path.push_back(city);
+    path.push_back(start);
+    return path;
+}
+
+int Two_level_list::index(int city) const {
+    const Block& block = blocks[locations[city].block];
+    return block.reversed ? block.end - 1 - locations[city].position : locations[city].position - block.begin;
+}
+
+int Two_level_list::city_at(int block, int index) const {
+    return blocks[block].reversed ? cities[blocks[block].end - 1 - index] : cities[blocks[block].begin + index];
+}
+
+int Two_level_list::raw_next(int city) const {
+    const Location& location = locations[city];
+    const Block& block = blocks[location.block];
+    if(!block.reversed && location.position + 1 < block.end) return cities[location.position + 1];
+    if(block.reversed && location.position > block.begin) return cities[location.position - 1];
+    return city_at(order[(block.rank + 1) % order.size()], 0);
+}
+
+int Two_level_list::raw_previous(int city) const {
+    const Location& location = locations[city];
+    const Block& block = blocks[location.block];
+    if(!block.reversed && location.position > block.begin) return cities[location.position - 1];
+    if(block.reversed && location.position + 1 < block.end) return cities[location.position + 1];
+    int previous_block = order[(block.rank + order.size() - 1) % order.size()];
+    return city_at(previous_block, blocks[previous_block].end - blocks[previous_block].begin - 1);
+}
+
+bool Two_level_list::raw_between(int a, int b, int c) const {
+    auto key = [&](int city) { return (long long)blocks[locations[city].block].rank * size() + index(city); };
+    long long key_a = key(a);
+    long long key_b = key(b);
+    long long key_c = key(c);
+
+    if(key_a <= key_c) return key_a <= key_b && key_b <= key_c;
+    return key_b >= key_a || key_b <= key_c;
+}
+
+int Two_level_list::path_length(int from, int to) const {
+    int from_rank = blocks[locations[from].block].rank;
+    int to_rank = blocks[locations[to].block].rank;
+    if(from_rank == to_rank && index(from) <= index(to)) return index(to) - index(from) + 1;
+
+    const Block& first = blocks[order[from_rank]];
+    int length = first.end - first.begin - index(from);
+    for(int rank = (from_rank + 1) % order.size(); rank != to_rank; rank = (rank + 1) % order.size()) {
+        length = length + blocks[order[rank]].end - blocks[order[rank]].begin;
+    }
+    return length + index(to) + 1;
+}
+
+void Two_level_list::raw_reverse(int from, int to) {
+    int length = path_length(from, to);
+    if(length == size()) {
+        reversed = !reversed;
+        return;
+    }
+    if(2 * length > size()) {
+        int complement_from = raw_next(to);
+        to = raw_previous(from);
+        from = complement_from;
+        reversed = !reversed;
+    }
+
+    split_before(from);
+    split_before(raw_next(to));
+    int from_rank = blocks[locations[from].block].rank;
+    int to_rank = blocks[locations[to].block].rank;
+    if(from_rank > to_rank) {
+        rotate(order.begin(), order.begin() + from_rank, order.end());
+        for(int rank = 0; rank < order.size(); rank++) blocks[order[rank]].rank = rank;
+        to_rank = to_rank + order.size() - from_rank;
+        from_rank = 0;
+    }
+
+    std::reverse(order.begin() + from_rank, order.begin() + to_rank + 1);
+    for(int rank = from_rank; rank <= to_rank; rank++) {
+        blocks[order[rank]].rank = rank;
+        blocks[order[rank]].reversed = !blocks[order[rank]].reversed;
+    }
+
+    if(order.size() > max_blocks) {
+        vector<int> path;
+        path.reserve(size());
+        for(int block : order) for(int k = 0; k < blocks[block].end - blocks[block].begin; k++) path.push_back(city_at(block, k));
+        rebuild(path);
+    }
+}
+
+void Two_level_list::split_before(int city) {
+    int k = index(city);
+    if(k == 0) return;
+
+    int block = locations[city].block;
+    int new_block = blocks.size();
+    blocks.push_back(blocks[block]);
+    Block& head = blocks[block];
+    Block& tail = blocks[new_block];
+    if(!head.reversed) head.end = tail.begin = head.begin + k;
+    else head.begin = tail.end = head.end - k;
+
+    for(int position = tail.begin; position < tail.end; position++) locations[cities[position]].block = new_block;
+    order.insert(order.begin() + head.rank + 1, new_block);
+    for(int rank = head.rank + 1; rank < order.size(); rank++) blocks[order[rank]].rank = rank;
+}
+
+void Two_level_list::rebuild(const vector<int>& path) {
+    int count = path.size();
+    int block_size = max(8, int(sqrt(double(count))));
+    int block_count = (count + block_size - 1) / block_size;
+
+    cities = path;
+    locations.resize(count);
+    blocks.resize(block_count);
+    order.resize(block_count);
+    for(int block = 0; block < block_count; block++) {
+        blocks[block] = Block{block * block_size, min(count, (block + 1) * block_size), false, block};
+        order[block] = block;
+        for(int position = blocks[block].begin; position < blocks[block].end; position++) locations[path[position]] = Location{block, position};
+    }
+    max_blocks = 2 * block_count + 8;
+}
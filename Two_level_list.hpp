@@ -0,0 +1,49 @@
+#ifndef TWO_LEVEL_LIST_HPP
+#define TWO_LEVEL_LIST_HPP
+#include <vector>
+
+using namespace std;
+
+class Two_level_list {
+
+public:
+    void set_tour(const vector<int>& path);
+    int size() const { return int(cities.size()); }
+    int next(int city) const { return reversed ? raw_previous(city) : raw_next(city); }
+    int previous(int city) const { return reversed ? raw_next(city) : raw_previous(city); }
+    bool between(int a, int b, int c) const { return reversed ? raw_between(c, b, a) : raw_between(a, b, c); }
+    void reverse(int from, int to);
+    vector<int> sequence(int start = 0) const;
+
+private:
+    struct Block {
+        int begin = 0;
+        int end = 0;
+        bool reversed = false;
+        int rank = 0;
+    };
+
+    struct Location {
+        int block;
+        int position;
+    };
+
+    vector<int> cities;
+    vector<Location> locations;
+    vector<Block> blocks;
+    vector<int> order;
+    bool reversed = false;
+    int max_blocks = 0;
+
+    int index(int city) const;
+    int city_at(int block, int index) const;
+    int raw_next(int city) const;
+    int raw_previous(int city) const;
+    bool raw_between(int a, int b, int c) const;
+    int path_length(int from, int to) const;
+    void raw_reverse(int from, int to);
+    void split_before(int city);
+    void rebuild(const vector<int>& path);
+};
+
+#endif